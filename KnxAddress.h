@@ -0,0 +1,116 @@
+#ifndef KnxAddress_h
+#define KnxAddress_h
+
+#include "Arduino.h"
+
+/*
+ * Parsing of address strings, usable at compile time (C++11 constexpr)
+ */
+class KnxAddressParser {
+    public:
+        // Decimal number at the start of s
+        static constexpr int number(const char* s, int value = 0) {
+            return (*s >= '0' && *s <= '9') ? number(s + 1, value * 10 + (*s - '0')) : value;
+        }
+
+        // Position after the next separator, or the end of s
+        static constexpr const char* skip(const char* s, char separator) {
+            return (*s == 0) ? s : ((*s == separator) ? s + 1 : skip(s + 1, separator));
+        }
+
+        static constexpr int count(const char* s, char separator) {
+            return (*s == 0) ? 0 : ((*s == separator) + count(s + 1, separator));
+        }
+};
+
+/*
+ * Group address as 2 byte value: main/middle/sub (5/3/8 bit)
+ * or main/sub (5/11 bit) for 2-level addresses
+ */
+class KnxGroupAddress {
+    public:
+        constexpr KnxGroupAddress() : _bytes{0, 0} {}
+        constexpr KnxGroupAddress(int mainGroup, int middleGroup, int subGroup)
+            : _bytes{(byte) (((mainGroup & B11111) << 3) | (middleGroup & B111)), (byte) subGroup} {}
+        // "1/2/3" or "1/515"
+        constexpr explicit KnxGroupAddress(const char* address)
+            : _bytes{(byte) (parse(address) >> 8), (byte) parse(address)} {}
+        // From the two bytes on the bus
+        static KnxGroupAddress fromBytes(const byte* address) {
+            return KnxGroupAddress(address[0] >> 3, address[0] & B111, address[1]);
+        }
+
+        constexpr int getMainGroup() const { return _bytes[0] >> 3; }
+        constexpr int getMiddleGroup() const { return _bytes[0] & B111; }
+        constexpr int getSubGroup() const { return _bytes[1]; }
+        constexpr uint16_t getValue() const { return ((unsigned int) _bytes[0] << 8) | _bytes[1]; }
+
+        // For the byte based API
+        byte* getBytes() { return _bytes; }
+
+        constexpr bool operator==(const KnxGroupAddress& other) const { return getValue() == other.getValue(); }
+        constexpr bool operator!=(const KnxGroupAddress& other) const { return getValue() != other.getValue(); }
+
+    private:
+        byte _bytes[2];
+
+        static constexpr uint16_t parse(const char* address) {
+            return (KnxAddressParser::count(address, '/') == 1)
+                ? ((unsigned int) (KnxAddressParser::number(address) & B11111) << 11)
+                    | (KnxAddressParser::number(KnxAddressParser::skip(address, '/')) & 0x7FF)
+                : ((unsigned int) (KnxAddressParser::number(address) & B11111) << 11)
+                    | ((unsigned int) (KnxAddressParser::number(KnxAddressParser::skip(address, '/')) & B111) << 8)
+                    | (KnxAddressParser::number(KnxAddressParser::skip(KnxAddressParser::skip(address, '/'), '/')) & 0xFF);
+        }
+};
+
+/*
+ * Individual (physical) address as 2 byte value: area.line.member (4/4/8 bit)
+ */
+class KnxIndividualAddress {
+    public:
+        constexpr KnxIndividualAddress() : _bytes{0, 0} {}
+        constexpr KnxIndividualAddress(int area, int line, int member)
+            : _bytes{(byte) (((area & B1111) << 4) | (line & B1111)), (byte) member} {}
+        // "1.1.20"
+        constexpr explicit KnxIndividualAddress(const char* address)
+            : _bytes{(byte) (parse(address) >> 8), (byte) parse(address)} {}
+        // From the two bytes on the bus
+        static KnxIndividualAddress fromBytes(const byte* address) {
+            return KnxIndividualAddress(address[0] >> 4, address[0] & B1111, address[1]);
+        }
+
+        constexpr int getArea() const { return _bytes[0] >> 4; }
+        constexpr int getLine() const { return _bytes[0] & B1111; }
+        constexpr int getMember() const { return _bytes[1]; }
+        constexpr uint16_t getValue() const { return ((unsigned int) _bytes[0] << 8) | _bytes[1]; }
+
+        // For the byte based API
+        byte* getBytes() { return _bytes; }
+
+        constexpr bool operator==(const KnxIndividualAddress& other) const { return getValue() == other.getValue(); }
+        constexpr bool operator!=(const KnxIndividualAddress& other) const { return getValue() != other.getValue(); }
+
+    private:
+        byte _bytes[2];
+
+        static constexpr uint16_t parse(const char* address) {
+            return ((unsigned int) (KnxAddressParser::number(address) & B1111) << 12)
+                | ((unsigned int) (KnxAddressParser::number(KnxAddressParser::skip(address, '.')) & B1111) << 8)
+                | (KnxAddressParser::number(KnxAddressParser::skip(KnxAddressParser::skip(address, '.'), '.')) & 0xFF);
+        }
+};
+
+// Address literals: "1/2/3"_ga, "1.1.20"_pa. Only guaranteed to be parsed
+// at compile time where a constant is required, e.g. for
+// constexpr KnxGroupAddress SWITCH = "1/2/3"_ga; as a function argument
+// the compiler may parse them at runtime.
+constexpr KnxGroupAddress operator"" _ga(const char* address, size_t) {
+    return KnxGroupAddress(address);
+}
+
+constexpr KnxIndividualAddress operator"" _pa(const char* address, size_t) {
+    return KnxIndividualAddress(address);
+}
+
+#endif
@@ -0,0 +1,168 @@
+#include "KnxBusLoad.h"
+
+#define SLOT_MS (TPUART_BUS_LOAD_WINDOW_MS / TPUART_BUS_LOAD_SLOTS)
+// 9.6 bit times per ms
+#define WINDOW_BITS ((unsigned long) TPUART_BUS_LOAD_WINDOW_MS * 48 / 5)
+
+static uint16_t saturate(unsigned long bits) {
+    return bits < 65535UL ? bits : 65535U;
+}
+
+static byte percent(unsigned long bits, unsigned long windowBits) {
+    return bits < windowBits ? bits * 100 / windowBits : 100;
+}
+
+/*
+ * The window up to now: the full slots and what passed of the current one
+ */
+static unsigned long measuredBits() {
+    return ((unsigned long) (TPUART_BUS_LOAD_SLOTS - 1) * SLOT_MS + millis() % SLOT_MS) * 48 / 5;
+}
+
+KnxBusLoad::KnxBusLoad() {
+    _budget[0] = TPUART_TX_BUDGET_SYSTEM;
+    _budget[1] = TPUART_TX_BUDGET_ALARM;
+    _budget[2] = TPUART_TX_BUDGET_HIGH;
+    _budget[3] = TPUART_TX_BUDGET_NORMAL;
+    _load_limit = TPUART_BUS_LOAD_LIMIT;
+    clear();
+}
+
+void KnxBusLoad::clear() {
+    for (int i = 0; i < TPUART_BUS_LOAD_SLOTS; i++) {
+        _busy[i] = 0;
+        for (int j = 0; j < 4; j++) {
+            _own[i][j] = 0;
+        }
+    }
+    _slot = millis() / SLOT_MS;
+    _last_frame_end = micros();
+}
+
+void KnxBusLoad::setBudget(KnxPriorityType priority, byte percent) {
+    _budget[priorityClass(priority)] = percent;
+}
+
+void KnxBusLoad::setLoadLimit(byte percent) {
+    _load_limit = percent;
+}
+
+/*
+ * The idle time before the frame counts as busy as far as it was actually
+ * observed, up to the idle time the frame needed
+ */
+void KnxBusLoad::addFrame(int length, unsigned long startMicros) {
+    advance();
+
+    // The control byte reaches us after its character went over the bus
+    unsigned long frameStart = startMicros - KNX_BUS_BITS_TO_MICROS(KNX_BUS_CHAR_BITS);
+    long gapMicros = (long) (frameStart - _last_frame_end);
+    unsigned int gap = KNX_BUS_IDLE_BITS;
+    if (gapMicros <= 0) {
+        gap = 0;
+    } else if (gapMicros < (long) KNX_BUS_BITS_TO_MICROS(KNX_BUS_IDLE_BITS)) {
+        gap = gapMicros * 6 / 625;
+    }
+
+    unsigned int bits = frameBits(length) - KNX_BUS_IDLE_BITS + gap;
+    byte slot = _slot % TPUART_BUS_LOAD_SLOTS;
+    _busy[slot] = saturate((unsigned long) _busy[slot] + bits);
+    _last_frame_end = frameStart + KNX_BUS_BITS_TO_MICROS(bits - gap);
+}
+
+void KnxBusLoad::addOwnFrame(int length, KnxPriorityType priority, bool acknowledged) {
+    advance();
+
+    unsigned long bits = frameBits(length);
+    if (!acknowledged) {
+        bits *= 1 + KNX_BUS_REPETITIONS;
+    }
+    byte slot = _slot % TPUART_BUS_LOAD_SLOTS;
+    byte c = priorityClass(priority);
+    _busy[slot] = saturate(_busy[slot] + bits);
+    _own[slot][c] = saturate(_own[slot][c] + bits);
+    _last_frame_end = micros();
+}
+
+/*
+ * A frame larger than the whole budget is still sent once the window holds
+ * nothing else of its class
+ */
+bool KnxBusLoad::maySend(int length, KnxPriorityType priority) {
+    advance();
+
+    byte c = priorityClass(priority);
+    unsigned long own = sumOwn(c);
+    if (own > 0 && (own + frameBits(length)) * 100 > _budget[c] * WINDOW_BITS) {
+        return false;
+    }
+    if (priority == KNX_PRIORITY_NORMAL && sumBusy() * 100 > _load_limit * measuredBits()) {
+        return false;
+    }
+    return true;
+}
+
+byte KnxBusLoad::getLoad() {
+    advance();
+    return percent(sumBusy(), measuredBits());
+}
+
+byte KnxBusLoad::getOwnLoad(KnxPriorityType priority) {
+    advance();
+    return percent(sumOwn(priorityClass(priority)), WINDOW_BITS);
+}
+
+/*
+ * Clears the slots that were left since the last call
+ */
+void KnxBusLoad::advance() {
+    unsigned long slot = millis() / SLOT_MS;
+    unsigned long passed = slot - _slot;
+    if (passed > TPUART_BUS_LOAD_SLOTS) {
+        passed = TPUART_BUS_LOAD_SLOTS;
+    }
+    for (unsigned long i = 1; i <= passed; i++) {
+        byte s = (_slot + i) % TPUART_BUS_LOAD_SLOTS;
+        _busy[s] = 0;
+        for (int j = 0; j < 4; j++) {
+            _own[s][j] = 0;
+        }
+    }
+    _slot = slot;
+}
+
+/*
+ * Idle time, characters, gap and acknowledge
+ */
+unsigned int KnxBusLoad::frameBits(int length) {
+    return KNX_BUS_IDLE_BITS + length * KNX_BUS_CHAR_BITS + KNX_BUS_ACK_GAP_BITS + KNX_BUS_CHAR_BITS;
+}
+
+byte KnxBusLoad::priorityClass(KnxPriorityType priority) {
+    switch (priority) {
+        case KNX_PRIORITY_SYSTEM:
+            return 0;
+        case KNX_PRIORITY_ALARM:
+            return 1;
+        case KNX_PRIORITY_HIGH:
+            return 2;
+        default:
+            return 3;
+    }
+}
+
+unsigned long KnxBusLoad::sumBusy() {
+    unsigned long sum = 0;
+    for (int i = 0; i < TPUART_BUS_LOAD_SLOTS; i++) {
+        sum += _busy[i];
+    }
+    return sum;
+}
+
+unsigned long KnxBusLoad::sumOwn(byte priorityClass) {
+    unsigned long sum = 0;
+    for (int i = 0; i < TPUART_BUS_LOAD_SLOTS; i++) {
+        sum += _own[i][priorityClass];
+    }
+    return sum;
+}
@@ -0,0 +1,92 @@
+#ifndef KnxBusLoad_h
+#define KnxBusLoad_h
+
+#include "Arduino.h"
+
+#include "KnxTelegram.h"
+
+// Window over which the bus load and the sending budgets are measured, in
+// TPUART_BUS_LOAD_SLOTS steps that slide along with millis()
+#ifndef TPUART_BUS_LOAD_WINDOW_MS
+#define TPUART_BUS_LOAD_WINDOW_MS 1000
+#endif
+
+#ifndef TPUART_BUS_LOAD_SLOTS
+#define TPUART_BUS_LOAD_SLOTS 4
+#endif
+
+#if TPUART_BUS_LOAD_WINDOW_MS / TPUART_BUS_LOAD_SLOTS > 6000
+#error "TPUART_BUS_LOAD_WINDOW_MS / TPUART_BUS_LOAD_SLOTS must be at most 6000"
+#endif
+
+// Share of the window our own telegrams may use, in percent, by priority
+#ifndef TPUART_TX_BUDGET_SYSTEM
+#define TPUART_TX_BUDGET_SYSTEM 100
+#endif
+#ifndef TPUART_TX_BUDGET_ALARM
+#define TPUART_TX_BUDGET_ALARM 100
+#endif
+#ifndef TPUART_TX_BUDGET_HIGH
+#define TPUART_TX_BUDGET_HIGH 50
+#endif
+#ifndef TPUART_TX_BUDGET_NORMAL
+#define TPUART_TX_BUDGET_NORMAL 30
+#endif
+
+// Telegrams of normal priority also wait while the bus is busier than this, in percent
+#ifndef TPUART_BUS_LOAD_LIMIT
+#define TPUART_BUS_LOAD_LIMIT 60
+#endif
+
+// Bus timing at 9600 bit/s, in bit times
+#define KNX_BUS_CHAR_BITS 13        // 11 bit character + 2 bit pause
+#define KNX_BUS_IDLE_BITS 50        // line free before a frame of normal priority
+#define KNX_BUS_ACK_GAP_BITS 15     // between frame and acknowledge
+#define KNX_BUS_REPETITIONS 3       // by the TPUART when a frame is not acknowledged
+
+#define KNX_BUS_BITS_TO_MICROS(bits) ((unsigned long) (bits) * 625 / 6)
+
+/*
+ * Bus utilization estimated from the frames the receive path sees and the
+ * frames we send, and the sending budget of each priority class. Only does
+ * bookkeeping: the caller asks maySend() and tries again later.
+ */
+class KnxBusLoad {
+    public:
+        KnxBusLoad();
+
+        void clear();
+        void setBudget(KnxPriorityType priority, byte percent);
+        void setLoadLimit(byte percent);
+
+        // Frame of another device whose control byte arrived at startMicros
+        void addFrame(int length, unsigned long startMicros);
+        // Frame we sent, when the TPUART confirmed it
+        void addOwnFrame(int length, KnxPriorityType priority, bool acknowledged);
+
+        // True if a frame of length and priority fits into the budget now
+        bool maySend(int length, KnxPriorityType priority);
+
+        // Of the time in the window, in percent
+        byte getLoad();
+        // Of the budget window, in percent
+        byte getOwnLoad(KnxPriorityType priority);
+
+        // 0 for system up to 3 for normal priority, also the order of sending
+        static byte priorityClass(KnxPriorityType priority);
+
+    private:
+        uint16_t _busy[TPUART_BUS_LOAD_SLOTS];      // bit times, all frames
+        uint16_t _own[TPUART_BUS_LOAD_SLOTS][4];    // bit times, our frames by priority
+        byte _budget[4];
+        byte _load_limit;
+        unsigned long _slot;                        // millis() / slot length of the current slot
+        unsigned long _last_frame_end;              // micros()
+
+        void advance();
+        static unsigned int frameBits(int length);
+        unsigned long sumBusy();
+        unsigned long sumOwn(byte priorityClass);
+};
+
+#endif
@@ -28,6 +28,9 @@ KnxDevice::KnxDevice(KnxTpUart* knxTpUart) {
 }
 
 void KnxDevice::loop() {
+    // handle confirmation timeouts of queued telegrams
+    _knxTpUart->loop();
+
     // prog switch button
     int button = digitalRead(PIN_PROG_BUTTON);
     if (button != _lastProgButtonValue) {
@@ -108,7 +111,7 @@ void KnxDevice::processTelegram() {
                 
                 CONSOLEDEBUG("--> KNX_COMMAND_INDIVIDUAL_ADDR_WRITE: %i.%i.%i", area, line, member);                
                 
-                _knxTpUart->setIndividualAddress(PA_INTEGER(area, line, member));
+                _knxTpUart->setIndividualAddress(KnxIndividualAddress(area, line, member));
                 
                 byte individualAddress[2];
                 _knxTpUart->getIndividualAddress(individualAddress);
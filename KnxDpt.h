@@ -0,0 +1,539 @@
+#ifndef KnxDpt_h
+#define KnxDpt_h
+
+#include "Arduino.h"
+
+/*
+ * Codecs for KNX datapoint types (DPT)
+ *
+ * Dpt<Main, Sub> encodes and decodes the value of a group telegram. data
+ * points to the APCI byte of the telegram (byte 7): values of up to 6 bit are
+ * stored in its low bits, longer values in the SIZE bytes following it.
+ * PAYLOAD_LENGTH is the payload length of the telegram (TPCI/APCI + SIZE).
+ *
+ * Sub = 0 is the plain encoding of the main type, subtypes with a different
+ * scaling have their own specialization (e.g. Dpt<5, 1> for 0..100%).
+ *
+ * see: http://www.mikrocontroller.net/attachment/151008/KNX_Twisted_Pair_Protokollbeschreibung.pdf
+ */
+template<int Main, int Sub = 0> struct Dpt;
+
+// DPT 2: 1 bit controlled
+struct KnxDptControl {
+    bool control;
+    bool value;
+};
+
+// DPT 3: 3 bit controlled (dimming, blinds)
+struct KnxDptStep {
+    bool control;       // increase / down
+    byte stepCode;      // 0 = break, 1..7 = 1/2^(stepCode-1) of range
+};
+
+// DPT 10: time of day, day 0 = no day, 1 = monday ... 7 = sunday
+struct KnxDptTime {
+    byte day;
+    byte hour;
+    byte minute;
+    byte second;
+};
+
+// DPT 11: date, year 1990..2089
+struct KnxDptDate {
+    byte day;
+    byte month;
+    int year;
+};
+
+// DPT 16: character string, up to 14 characters
+struct KnxDptString {
+    char text[15];
+};
+
+// DPT 18: scene control
+struct KnxDptSceneControl {
+    bool learn;
+    byte scene;     // 0..63
+};
+
+// DPT 19: date and time, year 1900..2155
+struct KnxDptDateTime {
+    int year;
+    byte month;
+    byte day;
+    byte dayOfWeek;
+    byte hour;
+    byte minute;
+    byte second;
+    uint16_t flags;     // fault, working day, ..., clock quality (2 bytes as on the bus)
+};
+
+// Values of up to 6 bit, stored in the APCI byte
+#define KNX_DPT_SMALL(bits, type) \
+    typedef type Type; \
+    static const int SIZE = 0; \
+    static const int PAYLOAD_LENGTH = 2; \
+    static void setBits(byte value, byte* data) { \
+        data[0] = (data[0] & B11000000) | (value & ((1 << (bits)) - 1)); \
+    } \
+    static byte getBits(const byte* data) { \
+        return data[0] & ((1 << (bits)) - 1); \
+    }
+
+// Values stored in the bytes following the APCI byte
+#define KNX_DPT_BYTES(size, type) \
+    typedef type Type; \
+    static const int SIZE = (size); \
+    static const int PAYLOAD_LENGTH = (size) + 2;
+
+/*
+ * Big endian integers as on the bus
+ */
+struct KnxDptBytes {
+    static void setUnsigned(uint32_t value, byte* data, int size) {
+        for (int i = size; i > 0; i--) {
+            data[i] = value;
+            value >>= 8;
+        }
+    }
+
+    static uint32_t getUnsigned(const byte* data, int size) {
+        uint32_t value = 0;
+        for (int i = 1; i <= size; i++) {
+            value = (value << 8) | data[i];
+        }
+        return value;
+    }
+};
+
+/*
+ * DPT 1
+ * 1 bit
+ */
+template<int Sub> struct Dpt<1, Sub> {
+    KNX_DPT_SMALL(1, bool)
+
+    static void encode(const Type& value, byte* data) {
+        setBits(value ? 1 : 0, data);
+    }
+
+    static Type decode(const byte* data) {
+        return getBits(data);
+    }
+};
+
+/*
+ * DPT 2
+ * 1 bit controlled
+ */
+template<int Sub> struct Dpt<2, Sub> {
+    KNX_DPT_SMALL(2, KnxDptControl)
+
+    static void encode(const Type& value, byte* data) {
+        setBits((value.control ? B10 : 0) | (value.value ? B01 : 0), data);
+    }
+
+    static Type decode(const byte* data) {
+        Type value;
+        value.control = getBits(data) & B10;
+        value.value = getBits(data) & B01;
+        return value;
+    }
+};
+
+/*
+ * DPT 3
+ * 3 bit controlled
+ */
+template<int Sub> struct Dpt<3, Sub> {
+    KNX_DPT_SMALL(4, KnxDptStep)
+
+    static void encode(const Type& value, byte* data) {
+        setBits((value.control ? B1000 : 0) | (value.stepCode & B111), data);
+    }
+
+    static Type decode(const byte* data) {
+        Type value;
+        value.control = getBits(data) & B1000;
+        value.stepCode = getBits(data) & B111;
+        return value;
+    }
+};
+
+/*
+ * DPT 5
+ * 8 bit unsigned, raw value (e.g. 5.010 counter pulses)
+ */
+template<int Sub> struct Dpt<5, Sub> {
+    KNX_DPT_BYTES(1, byte)
+
+    static void encode(const Type& value, byte* data) {
+        data[1] = value;
+    }
+
+    static Type decode(const byte* data) {
+        return data[1];
+    }
+};
+
+/*
+ * DPT 5.001
+ * Scaling 0..100%
+ */
+template<> struct Dpt<5, 1> {
+    KNX_DPT_BYTES(1, byte)
+
+    static void encode(const Type& value, byte* data) {
+        data[1] = ((unsigned int) (value > 100 ? 100 : value) * 255 + 50) / 100;
+    }
+
+    static Type decode(const byte* data) {
+        return ((unsigned int) data[1] * 100 + 127) / 255;
+    }
+};
+
+/*
+ * DPT 5.003
+ * Angle 0..360 degrees
+ */
+template<> struct Dpt<5, 3> {
+    KNX_DPT_BYTES(1, int)
+
+    static void encode(const Type& value, byte* data) {
+        data[1] = ((unsigned long) (value > 360 ? 360 : (value < 0 ? 0 : value)) * 255 + 180) / 360;
+    }
+
+    static Type decode(const byte* data) {
+        return ((unsigned long) data[1] * 360 + 127) / 255;
+    }
+};
+
+/*
+ * DPT 6
+ * 8 bit signed
+ */
+template<int Sub> struct Dpt<6, Sub> {
+    KNX_DPT_BYTES(1, int8_t)
+
+    static void encode(const Type& value, byte* data) {
+        data[1] = (byte) value;
+    }
+
+    static Type decode(const byte* data) {
+        return (int8_t) data[1];
+    }
+};
+
+/*
+ * DPT 7
+ * 16 bit unsigned
+ */
+template<int Sub> struct Dpt<7, Sub> {
+    KNX_DPT_BYTES(2, uint16_t)
+
+    static void encode(const Type& value, byte* data) {
+        KnxDptBytes::setUnsigned(value, data, SIZE);
+    }
+
+    static Type decode(const byte* data) {
+        return KnxDptBytes::getUnsigned(data, SIZE);
+    }
+};
+
+/*
+ * DPT 8
+ * 16 bit signed
+ */
+template<int Sub> struct Dpt<8, Sub> {
+    KNX_DPT_BYTES(2, int16_t)
+
+    static void encode(const Type& value, byte* data) {
+        KnxDptBytes::setUnsigned((uint16_t) value, data, SIZE);
+    }
+
+    static Type decode(const byte* data) {
+        return (int16_t) KnxDptBytes::getUnsigned(data, SIZE);
+    }
+};
+
+/*
+ * DPT 9
+ * 2 byte float: 0.01 * mantissa * 2^exponent, 12 bit two's complement
+ * mantissa (sign bit + 11 bit) and 4 bit exponent
+ *
+ * encodeCenti/decodeCenti work on hundredths (e.g. 2150 = 21.50 °C)
+ * with integer arithmetic only, for MCUs without FPU.
+ */
+template<int Sub> struct Dpt<9, Sub> {
+    KNX_DPT_BYTES(2, float)
+
+    // Largest value: 2047 * 2^15
+    static const long MAX_CENTI = 67076096L;
+    static const long MIN_CENTI = -67108864L;
+
+    static void encodeCenti(long centi, byte* data) {
+        if (centi > MAX_CENTI) {
+            centi = MAX_CENTI;
+        } else if (centi < MIN_CENTI) {
+            centi = MIN_CENTI;
+        }
+
+        // Smallest exponent for which the rounded mantissa fits into 12 bit
+        int exponent = 0;
+        long mantissa = centi;
+        while (mantissa < -2048 || mantissa > 2047) {
+            exponent++;
+            long half = 1L << (exponent - 1);
+            if (centi >= 0) {
+                mantissa = (centi + half) >> exponent;
+            } else {
+                mantissa = -((-centi + half) >> exponent);
+            }
+        }
+
+        unsigned int bits = mantissa & 0x7FF;
+        data[1] = (mantissa < 0 ? B10000000 : 0) | (exponent << 3) | (bits >> 8);
+        data[2] = bits & 0xFF;
+    }
+
+    static long decodeCenti(const byte* data) {
+        int exponent = (data[1] & B01111000) >> 3;
+        long mantissa = ((data[1] & B00000111) << 8) | data[2];
+        if (data[1] & B10000000) {
+            mantissa -= 2048;
+        }
+        return mantissa * (1L << exponent);
+    }
+
+    static void encode(const Type& value, byte* data) {
+        float centi = value * 100.0f;
+        if (centi > MAX_CENTI) {
+            centi = MAX_CENTI;
+        } else if (centi < MIN_CENTI) {
+            centi = MIN_CENTI;
+        }
+        encodeCenti((long) (centi < 0 ? centi - 0.5f : centi + 0.5f), data);
+    }
+
+    static Type decode(const byte* data) {
+        return decodeCenti(data) * 0.01f;
+    }
+};
+
+/*
+ * DPT 10
+ * Time of day
+ */
+template<int Sub> struct Dpt<10, Sub> {
+    KNX_DPT_BYTES(3, KnxDptTime)
+
+    static void encode(const Type& value, byte* data) {
+        data[1] = ((value.day & B111) << 5) | (value.hour & B11111);
+        data[2] = value.minute & B111111;
+        data[3] = value.second & B111111;
+    }
+
+    static Type decode(const byte* data) {
+        Type value;
+        value.day = data[1] >> 5;
+        value.hour = data[1] & B11111;
+        value.minute = data[2] & B111111;
+        value.second = data[3] & B111111;
+        return value;
+    }
+};
+
+/*
+ * DPT 11
+ * Date
+ */
+template<int Sub> struct Dpt<11, Sub> {
+    KNX_DPT_BYTES(3, KnxDptDate)
+
+    static void encode(const Type& value, byte* data) {
+        data[1] = value.day & B11111;
+        data[2] = value.month & B1111;
+        data[3] = (value.year % 100) & B1111111;
+    }
+
+    static Type decode(const byte* data) {
+        Type value;
+        value.day = data[1] & B11111;
+        value.month = data[2] & B1111;
+        int year = data[3] & B1111111;
+        value.year = (year >= 90) ? 1900 + year : 2000 + year;
+        return value;
+    }
+};
+
+/*
+ * DPT 12
+ * 32 bit unsigned
+ */
+template<int Sub> struct Dpt<12, Sub> {
+    KNX_DPT_BYTES(4, uint32_t)
+
+    static void encode(const Type& value, byte* data) {
+        KnxDptBytes::setUnsigned(value, data, SIZE);
+    }
+
+    static Type decode(const byte* data) {
+        return KnxDptBytes::getUnsigned(data, SIZE);
+    }
+};
+
+/*
+ * DPT 13
+ * 32 bit signed
+ */
+template<int Sub> struct Dpt<13, Sub> {
+    KNX_DPT_BYTES(4, int32_t)
+
+    static void encode(const Type& value, byte* data) {
+        KnxDptBytes::setUnsigned((uint32_t) value, data, SIZE);
+    }
+
+    static Type decode(const byte* data) {
+        return (int32_t) KnxDptBytes::getUnsigned(data, SIZE);
+    }
+};
+
+/*
+ * DPT 14
+ * 4 byte IEEE 754 float
+ */
+template<int Sub> struct Dpt<14, Sub> {
+    KNX_DPT_BYTES(4, float)
+
+    static void encode(const Type& value, byte* data) {
+        uint32_t bits;
+        memcpy(&bits, &value, 4);
+        KnxDptBytes::setUnsigned(bits, data, SIZE);
+    }
+
+    static Type decode(const byte* data) {
+        uint32_t bits = KnxDptBytes::getUnsigned(data, SIZE);
+        Type value;
+        memcpy(&value, &bits, 4);
+        return value;
+    }
+};
+
+/*
+ * DPT 16
+ * Character string, 14 byte, padded with 0
+ */
+template<int Sub> struct Dpt<16, Sub> {
+    KNX_DPT_BYTES(14, KnxDptString)
+
+    static void encode(const Type& value, byte* data) {
+        encode(value.text, data);
+    }
+
+    static void encode(const char* text, byte* data) {
+        int i = 0;
+        for (; i < SIZE && text[i] != 0; i++) {
+            data[1 + i] = text[i];
+        }
+        for (; i < SIZE; i++) {
+            data[1 + i] = 0;
+        }
+    }
+
+    static Type decode(const byte* data) {
+        Type value;
+        for (int i = 0; i < SIZE; i++) {
+            value.text[i] = data[1 + i];
+        }
+        value.text[SIZE] = 0;
+        return value;
+    }
+};
+
+/*
+ * DPT 17
+ * Scene number 0..63
+ */
+template<int Sub> struct Dpt<17, Sub> {
+    KNX_DPT_BYTES(1, byte)
+
+    static void encode(const Type& value, byte* data) {
+        data[1] = value & B111111;
+    }
+
+    static Type decode(const byte* data) {
+        return data[1] & B111111;
+    }
+};
+
+/*
+ * DPT 18
+ * Scene control: activate or learn scene
+ */
+template<int Sub> struct Dpt<18, Sub> {
+    KNX_DPT_BYTES(1, KnxDptSceneControl)
+
+    static void encode(const Type& value, byte* data) {
+        data[1] = (value.learn ? B10000000 : 0) | (value.scene & B111111);
+    }
+
+    static Type decode(const byte* data) {
+        Type value;
+        value.learn = data[1] & B10000000;
+        value.scene = data[1] & B111111;
+        return value;
+    }
+};
+
+/*
+ * DPT 19
+ * Date and time
+ */
+template<int Sub> struct Dpt<19, Sub> {
+    KNX_DPT_BYTES(8, KnxDptDateTime)
+
+    static void encode(const Type& value, byte* data) {
+        data[1] = value.year - 1900;
+        data[2] = value.month & B1111;
+        data[3] = value.day & B11111;
+        data[4] = ((value.dayOfWeek & B111) << 5) | (value.hour & B11111);
+        data[5] = value.minute & B111111;
+        data[6] = value.second & B111111;
+        data[7] = value.flags >> 8;
+        data[8] = value.flags & 0xFF;
+    }
+
+    static Type decode(const byte* data) {
+        Type value;
+        value.year = 1900 + data[1];
+        value.month = data[2] & B1111;
+        value.day = data[3] & B11111;
+        value.dayOfWeek = data[4] >> 5;
+        value.hour = data[4] & B11111;
+        value.minute = data[5] & B111111;
+        value.second = data[6] & B111111;
+        value.flags = ((uint16_t) data[7] << 8) | data[8];
+        return value;
+    }
+};
+
+/*
+ * DPT 20
+ * 8 bit enumeration (e.g. 20.102 HVAC mode)
+ */
+template<int Sub> struct Dpt<20, Sub> {
+    KNX_DPT_BYTES(1, byte)
+
+    static void encode(const Type& value, byte* data) {
+        data[1] = value;
+    }
+
+    static Type decode(const byte* data) {
+        return data[1];
+    }
+};
+
+#undef KNX_DPT_SMALL
+#undef KNX_DPT_BYTES
+
+#endif
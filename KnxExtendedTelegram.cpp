@@ -0,0 +1,148 @@
+#include "KnxTelegram.h"
+
+KnxExtendedTelegram::KnxExtendedTelegram() {
+    clear();
+}
+
+void KnxExtendedTelegram::clear() {
+    for (int i = 0; i < MAX_KNX_EXTENDED_TELEGRAM_SIZE; i++) {
+        buffer[i] = 0;
+    }
+
+    // Control Field: Extended Frame, Normal Priority, No Repeat
+    buffer[0] = B00111100;
+
+    // Extended Control Field: Target Group Address, Routing Counter = 6
+    buffer[1] = B11100000;
+
+    // Length = 1 (= 2 Bytes)
+    buffer[6] = 1;
+}
+
+KnxTelegramView KnxExtendedTelegram::getView() {
+    return KnxTelegramView(buffer, MAX_KNX_EXTENDED_TELEGRAM_SIZE);
+}
+
+const byte* KnxExtendedTelegram::getBuffer() {
+    return buffer;
+}
+
+void KnxExtendedTelegram::setBufferByte(int index, int content) {
+    if (index >= 0 && index < MAX_KNX_EXTENDED_TELEGRAM_SIZE) {
+        buffer[index] = content;
+    }
+}
+
+int KnxExtendedTelegram::getBufferByte(int index) {
+    if (index < 0 || index >= MAX_KNX_EXTENDED_TELEGRAM_SIZE) {
+        return 0;
+    }
+    return buffer[index];
+}
+
+void KnxExtendedTelegram::setPayloadLength(int length) {
+    if (length < 2) {
+        length = 2;
+    } else if (length > MAX_KNX_EXTENDED_PAYLOAD_LENGTH) {
+        length = MAX_KNX_EXTENDED_PAYLOAD_LENGTH;
+    }
+    buffer[6] = length - 1;
+}
+
+int KnxExtendedTelegram::getPayloadLength() {
+    return getView().getPayloadLength();
+}
+
+void KnxExtendedTelegram::setRepeated(bool repeat) {
+    if (repeat) {
+        buffer[0] = buffer[0] & B11011111;
+    } else {
+        buffer[0] = buffer[0] | B00100000;
+    }
+}
+
+void KnxExtendedTelegram::setPriority(KnxPriorityType prio) {
+    buffer[0] = buffer[0] & B11110011;
+    buffer[0] = buffer[0] | (prio << 2);
+}
+
+KnxPriorityType KnxExtendedTelegram::getPriority() {
+    return getView().getPriority();
+}
+
+void KnxExtendedTelegram::setSourceAddress(KnxIndividualAddress sourceAddress) {
+    buffer[2] = sourceAddress.getBytes()[0];
+    buffer[3] = sourceAddress.getBytes()[1];
+}
+
+void KnxExtendedTelegram::setTargetGroupAddress(KnxGroupAddress targetGroupAddress) {
+    buffer[4] = targetGroupAddress.getBytes()[0];
+    buffer[5] = targetGroupAddress.getBytes()[1];
+    buffer[1] = buffer[1] | B10000000;
+}
+
+void KnxExtendedTelegram::setTargetIndividualAddress(KnxIndividualAddress targetIndividualAddress) {
+    buffer[4] = targetIndividualAddress.getBytes()[0];
+    buffer[5] = targetIndividualAddress.getBytes()[1];
+    buffer[1] = buffer[1] & B01111111;
+}
+
+bool KnxExtendedTelegram::isTargetGroup() {
+    return getView().isTargetGroup();
+}
+
+void KnxExtendedTelegram::setRoutingCounter(int counter) {
+    buffer[1] = buffer[1] & B10001111;
+    buffer[1] = buffer[1] | (counter << 4);
+}
+
+void KnxExtendedTelegram::setCommand(KnxCommandType command) {
+    buffer[7] = buffer[7] & B11111100; // erase first two bits
+    buffer[8] = buffer[8] & B00111111; // erase last two bits
+
+    buffer[7] = buffer[7] | (command >> 2); // Command first two bits
+    buffer[8] = buffer[8] | (command << 6); // Command last two bits
+}
+
+void KnxExtendedTelegram::setExtendedCommand(KnxExtendedCommandType extCommand) {
+    buffer[8] = buffer[8] & B11000000;
+    buffer[8] = buffer[8] | extCommand;
+}
+
+void KnxExtendedTelegram::setCommunicationType(KnxCommunicationType type) {
+    buffer[7] = buffer[7] & B00111111;
+    buffer[7] = buffer[7] | (type << 6);
+}
+
+void KnxExtendedTelegram::setSequenceNumber(int number) {
+    buffer[7] = buffer[7] & B11000011;
+    buffer[7] = buffer[7] | (number << 2);
+}
+
+void KnxExtendedTelegram::setFirstDataByte(int data) {
+    buffer[8] = buffer[8] & B11000000;
+    buffer[8] = buffer[8] | data;
+}
+
+void KnxExtendedTelegram::setData(const byte* data, int length) {
+    if (length > MAX_KNX_EXTENDED_PAYLOAD_LENGTH - 2) {
+        length = MAX_KNX_EXTENDED_PAYLOAD_LENGTH - 2;
+    }
+    for (int i = 0; i < length; i++) {
+        buffer[9 + i] = data[i];
+    }
+    setPayloadLength(length + 2);
+}
+
+void KnxExtendedTelegram::createChecksum() {
+    int checksumPos = getPayloadLength() + KNX_EXTENDED_TELEGRAM_HEADER_SIZE;
+    setBufferByte(checksumPos, getView().calculateChecksum());
+}
+
+bool KnxExtendedTelegram::verifyChecksum() {
+    return getView().verifyChecksum();
+}
+
+int KnxExtendedTelegram::getTotalLength() {
+    return getView().getTotalLength();
+}
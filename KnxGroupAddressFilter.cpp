@@ -0,0 +1,142 @@
+#include "KnxGroupAddressFilter.h"
+
+KnxGroupAddressFilter::KnxGroupAddressFilter() {
+    clear();
+}
+
+void KnxGroupAddressFilter::clear() {
+    _count = 0;
+
+    for (int i = 0; i < 32; i++) {
+        _ranges[i] = 0;
+    }
+
+#if TPUART_GA_FILTER != TPUART_GA_FILTER_SORTED
+    for (int i = 0; i < (1 << TPUART_GA_FILTER_HASH_BITS); i++) {
+        _slots[i] = 0;
+    }
+#endif
+#if TPUART_GA_FILTER == TPUART_GA_FILTER_BITMAP
+    memset(_bits, 0, sizeof(_bits));
+#endif
+}
+
+int KnxGroupAddressFilter::add(byte groupAddress[2]) {
+    uint16_t key = (groupAddress[0] << 8) | groupAddress[1];
+
+#if TPUART_GA_FILTER == TPUART_GA_FILTER_SORTED
+    int pos = findPosition(key);
+    if (pos < _count && _keys[_order[pos]] == key) {
+        // Already listening
+        return _order[pos];
+    }
+    if (_count >= MAX_LISTEN_GROUP_ADDRESSES) {
+        return -1;
+    }
+
+    for (int i = _count; i > pos; i--) {
+        _order[i] = _order[i - 1];
+    }
+    _order[pos] = _count;
+#else
+    int slot = findSlot(key);
+    if (_slots[slot] != 0) {
+        // Already listening
+        return _slots[slot] - 1;
+    }
+    if (_count >= MAX_LISTEN_GROUP_ADDRESSES) {
+        return -1;
+    }
+
+    _slots[slot] = _count + 1;
+#endif
+#if TPUART_GA_FILTER == TPUART_GA_FILTER_BITMAP
+    _bits[key >> 3] |= (1 << (key & B111));
+#endif
+
+    _keys[_count] = key;
+    return _count++;
+}
+
+void KnxGroupAddressFilter::addMainGroup(int mainGroup) {
+    _ranges[mainGroup & B11111] = B11111111;
+}
+
+void KnxGroupAddressFilter::addMiddleGroup(int mainGroup, int middleGroup) {
+    _ranges[mainGroup & B11111] |= (1 << (middleGroup & B111));
+}
+
+bool KnxGroupAddressFilter::contains(byte groupAddress[2]) {
+    // Main/middle group ranges, first address byte is main << 3 | middle
+    if (_ranges[(groupAddress[0] >> 3) & B11111] & (1 << (groupAddress[0] & B111))) {
+        return true;
+    }
+
+#if TPUART_GA_FILTER == TPUART_GA_FILTER_BITMAP
+    uint16_t key = (groupAddress[0] << 8) | groupAddress[1];
+    return _bits[key >> 3] & (1 << (key & B111));
+#else
+    return indexOf(groupAddress) >= 0;
+#endif
+}
+
+int KnxGroupAddressFilter::indexOf(byte groupAddress[2]) {
+    uint16_t key = (groupAddress[0] << 8) | groupAddress[1];
+
+#if TPUART_GA_FILTER == TPUART_GA_FILTER_SORTED
+    int pos = findPosition(key);
+    if (pos < _count && _keys[_order[pos]] == key) {
+        return _order[pos];
+    }
+    return -1;
+#else
+#if TPUART_GA_FILTER == TPUART_GA_FILTER_BITMAP
+    if (!(_bits[key >> 3] & (1 << (key & B111)))) {
+        // Most addresses on the bus are not ours, skip probing for them
+        return -1;
+    }
+#endif
+    return _slots[findSlot(key)] - 1;
+#endif
+}
+
+int KnxGroupAddressFilter::getCount() {
+    return _count;
+}
+
+#if TPUART_GA_FILTER == TPUART_GA_FILTER_SORTED
+/*
+ * Binary search: position of key in _order, or where it has to be inserted
+ */
+int KnxGroupAddressFilter::findPosition(uint16_t key) {
+    int low = 0;
+    int high = _count;
+
+    while (low < high) {
+        int mid = (low + high) >> 1;
+        if (_keys[_order[mid]] < key) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    return low;
+}
+#else
+/*
+ * Linear probing: slot containing key, or the empty slot where it has to be inserted
+ */
+int KnxGroupAddressFilter::findSlot(uint16_t key) {
+    const int mask = (1 << TPUART_GA_FILTER_HASH_BITS) - 1;
+
+    // Fibonacci hashing, 40503 = 2^16 / golden ratio
+    int slot = ((uint16_t)(key * 40503u)) >> (16 - TPUART_GA_FILTER_HASH_BITS);
+
+    while (_slots[slot] != 0 && _keys[_slots[slot] - 1] != key) {
+        slot = (slot + 1) & mask;
+    }
+
+    return slot;
+}
+#endif
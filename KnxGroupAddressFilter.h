@@ -0,0 +1,76 @@
+#ifndef KnxGroupAddressFilter_h
+#define KnxGroupAddressFilter_h
+
+#include "Arduino.h"
+
+// Backends for looking up the group addresses that are listened on
+#define TPUART_GA_FILTER_SORTED 1   // sorted array + binary search, least RAM (AVR)
+#define TPUART_GA_FILTER_HASH 2     // open addressing hash table (mid-range MCUs)
+#define TPUART_GA_FILTER_BITMAP 3   // 65536 bit bitmap, 8 KB (hosts with RAM)
+
+// Select the backend at compile time
+#ifndef TPUART_GA_FILTER
+#define TPUART_GA_FILTER TPUART_GA_FILTER_SORTED
+#endif
+
+// Maximum number of group addresses that can be listened on
+#ifndef MAX_LISTEN_GROUP_ADDRESSES
+#define MAX_LISTEN_GROUP_ADDRESSES 48
+#endif
+
+// Number of hash table slots as power of 2, must be at least twice the capacity
+#ifndef TPUART_GA_FILTER_HASH_BITS
+#define TPUART_GA_FILTER_HASH_BITS 7
+#endif
+
+#if (TPUART_GA_FILTER != TPUART_GA_FILTER_SORTED) && ((1 << TPUART_GA_FILTER_HASH_BITS) < 2 * MAX_LISTEN_GROUP_ADDRESSES)
+#error "TPUART_GA_FILTER_HASH_BITS too small for MAX_LISTEN_GROUP_ADDRESSES"
+#endif
+
+#if MAX_LISTEN_GROUP_ADDRESSES > 255
+typedef uint16_t KnxFilterIndex;
+#else
+typedef byte KnxFilterIndex;
+#endif
+
+/*
+ * Set of group addresses, with single addresses and whole main/middle groups.
+ * Lookup time does not depend on the number of addresses (hash, bitmap) or
+ * grows logarithmically (sorted).
+ */
+class KnxGroupAddressFilter {
+    public:
+        KnxGroupAddressFilter();
+
+        void clear();
+
+        // Returns the index of the address entry, -1 if the filter is full
+        int add(byte* groupAddress);
+        // Listen to all addresses main/x/x
+        void addMainGroup(int mainGroup);
+        // Listen to all addresses main/middle/x
+        void addMiddleGroup(int mainGroup, int middleGroup);
+
+        bool contains(byte* groupAddress);
+        // Index of a single address entry (stable, in order of adding), -1 if not added
+        int indexOf(byte* groupAddress);
+        int getCount();
+
+    private:
+        uint16_t _keys[MAX_LISTEN_GROUP_ADDRESSES];    // in order of adding
+        KnxFilterIndex _count;
+        byte _ranges[32];   // one bit per main/middle group, indexed by first address byte
+
+#if TPUART_GA_FILTER == TPUART_GA_FILTER_SORTED
+        KnxFilterIndex _order[MAX_LISTEN_GROUP_ADDRESSES];   // indexes of _keys, sorted by key
+        int findPosition(uint16_t key);
+#else
+        KnxFilterIndex _slots[1 << TPUART_GA_FILTER_HASH_BITS];  // index + 1, 0 = empty
+        int findSlot(uint16_t key);
+#endif
+#if TPUART_GA_FILTER == TPUART_GA_FILTER_BITMAP
+        byte _bits[8192];
+#endif
+};
+
+#endif
@@ -0,0 +1,52 @@
+#include "KnxGroupHandlerTable.h"
+
+KnxGroupHandlerTable::KnxGroupHandlerTable() {
+    clear();
+}
+
+void KnxGroupHandlerTable::clear() {
+    for (int i = 0; i < MAX_LISTEN_GROUP_ADDRESSES; i++) {
+        _heads[i] = 0;
+    }
+    _count = 0;
+}
+
+bool KnxGroupHandlerTable::add(int filterIndex, KnxCommandType command, KnxGroupHandler handler, void* context) {
+    if (filterIndex < 0 || filterIndex >= MAX_LISTEN_GROUP_ADDRESSES) {
+        return false;
+    }
+
+    for (byte e = _heads[filterIndex]; e != 0; e = _entries[e - 1].next) {
+        if (_entries[e - 1].command == command) {
+            _entries[e - 1].handler = handler;
+            _entries[e - 1].context = context;
+            return true;
+        }
+    }
+
+    if (_count >= MAX_GROUP_HANDLERS) {
+        return false;
+    }
+
+    Entry* entry = &_entries[_count];
+    entry->handler = handler;
+    entry->context = context;
+    entry->command = command;
+    entry->next = _heads[filterIndex];
+    _heads[filterIndex] = ++_count;
+    return true;
+}
+
+bool KnxGroupHandlerTable::dispatch(int filterIndex, KnxCommandType command, KnxTelegram* telegram) {
+    if (filterIndex < 0) {
+        return false;
+    }
+
+    for (byte e = _heads[filterIndex]; e != 0; e = _entries[e - 1].next) {
+        if (_entries[e - 1].command == command) {
+            _entries[e - 1].handler(telegram, _entries[e - 1].context);
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,51 @@
+#ifndef KnxGroupHandlerTable_h
+#define KnxGroupHandlerTable_h
+
+#include "Arduino.h"
+
+#include "KnxTelegram.h"
+#include "KnxGroupAddressFilter.h"
+
+// Maximum number of handlers, one per (group address, command)
+#ifndef MAX_GROUP_HANDLERS
+#define MAX_GROUP_HANDLERS 16
+#endif
+
+#if MAX_GROUP_HANDLERS > 255
+#error "MAX_GROUP_HANDLERS must be at most 255"
+#endif
+
+// Called with the received telegram and the context given when registering
+typedef void (*KnxGroupHandler)(KnxTelegram* telegram, void* context);
+
+/*
+ * Handlers for received group telegrams, keyed by the index of the group
+ * address in KnxGroupAddressFilter and the command. The filter lookup done
+ * for the acknowledge also finds the handler, the commands of an address
+ * are a short chain (read, write, answer).
+ */
+class KnxGroupHandlerTable {
+    public:
+        KnxGroupHandlerTable();
+
+        void clear();
+
+        // Replaces an existing handler for the same key. Returns false if the table is full.
+        bool add(int filterIndex, KnxCommandType command, KnxGroupHandler handler, void* context);
+        // Calls the handler, returns false if there is none
+        bool dispatch(int filterIndex, KnxCommandType command, KnxTelegram* telegram);
+
+    private:
+        struct Entry {
+            KnxGroupHandler handler;
+            void* context;
+            byte command;
+            byte next;      // entry + 1, 0 = end of chain
+        };
+
+        byte _heads[MAX_LISTEN_GROUP_ADDRESSES];   // entry + 1 per filter index, 0 = none
+        Entry _entries[MAX_GROUP_HANDLERS];
+        byte _count;
+};
+
+#endif
@@ -0,0 +1,65 @@
+#include "KnxGroupObjectTable.h"
+
+KnxGroupObjectTable::KnxGroupObjectTable() {
+    clear();
+}
+
+void KnxGroupObjectTable::clear() {
+    for (int i = 0; i < MAX_LISTEN_GROUP_ADDRESSES; i++) {
+        _objects_by_index[i] = 0;
+    }
+    _count = 0;
+}
+
+bool KnxGroupObjectTable::add(int filterIndex, byte flags) {
+    if (filterIndex < 0 || filterIndex >= MAX_LISTEN_GROUP_ADDRESSES) {
+        return false;
+    }
+
+    KnxGroupObject* object = find(filterIndex);
+    if (object == 0) {
+        if (_count >= MAX_GROUP_OBJECTS) {
+            return false;
+        }
+        object = &_objects[_count];
+        object->flags = 0;
+        object->payloadLength = 0;
+        _objects_by_index[filterIndex] = ++_count;
+    }
+
+    // Keeps the value when added again
+    object->flags = (object->flags & KNX_GROUP_OBJECT_VALID) | (flags & ~KNX_GROUP_OBJECT_VALID);
+    return true;
+}
+
+KnxGroupObject* KnxGroupObjectTable::find(int filterIndex) {
+    if (filterIndex < 0 || _objects_by_index[filterIndex] == 0) {
+        return 0;
+    }
+    return &_objects[_objects_by_index[filterIndex] - 1];
+}
+
+bool KnxGroupObjectTable::update(KnxGroupObject* object, KnxTelegram* telegram) {
+    int length = telegram->getPayloadLength();
+    if (length < 2 || length - 1 > (int) sizeof(object->data)) {
+        object->flags &= ~KNX_GROUP_OBJECT_VALID;
+        object->payloadLength = 0;
+        return false;
+    }
+
+    object->payloadLength = length;
+    object->data[0] = telegram->getBufferByte(7) & B00111111;
+    for (int i = 1; i < length - 1; i++) {
+        object->data[i] = telegram->getBufferByte(7 + i);
+    }
+    object->flags |= KNX_GROUP_OBJECT_VALID;
+    return true;
+}
+
+void KnxGroupObjectTable::copyValue(KnxGroupObject* object, KnxTelegram* telegram) {
+    telegram->setPayloadLength(object->payloadLength);
+    telegram->setFirstDataByte(object->data[0]);
+    for (int i = 1; i < object->payloadLength - 1; i++) {
+        telegram->setBufferByte(7 + i, object->data[i]);
+    }
+}
@@ -0,0 +1,65 @@
+#ifndef KnxGroupObjectTable_h
+#define KnxGroupObjectTable_h
+
+#include "Arduino.h"
+
+#include "KnxTelegram.h"
+#include "KnxGroupAddressFilter.h"
+
+// Maximum number of group objects with cached value
+#ifndef MAX_GROUP_OBJECTS
+#define MAX_GROUP_OBJECTS 8
+#endif
+
+// Value bytes cached per group object after the APCI byte: 4 fits all DPTs
+// up to DPT 14, 14 is needed for DPT 16 strings
+#ifndef TPUART_GROUP_OBJECT_SIZE
+#define TPUART_GROUP_OBJECT_SIZE 4
+#endif
+
+#if MAX_GROUP_OBJECTS > 255
+#error "MAX_GROUP_OBJECTS must be at most 255"
+#endif
+
+// Flags of a group object
+#define KNX_GROUP_OBJECT_VALID B0001         // has a value
+#define KNX_GROUP_OBJECT_NOTIFY_READ B0010   // read requests are reported to the application too
+
+/*
+ * Last value of a group object, as in the telegram: payload length and the
+ * data from the APCI byte on (low 6 bits of the APCI byte for small values)
+ */
+struct KnxGroupObject {
+    byte flags;
+    byte payloadLength;
+    byte data[TPUART_GROUP_OBJECT_SIZE + 1];
+};
+
+/*
+ * Value cache for group objects, keyed by the index of the group address in
+ * KnxGroupAddressFilter like KnxGroupHandlerTable
+ */
+class KnxGroupObjectTable {
+    public:
+        KnxGroupObjectTable();
+
+        void clear();
+
+        // Returns false if the table is full
+        bool add(int filterIndex, byte flags);
+        // 0 if the address has no group object
+        KnxGroupObject* find(int filterIndex);
+
+        // Takes the value of a write or answer telegram, returns false if it
+        // does not fit (the object then has no value)
+        bool update(KnxGroupObject* object, KnxTelegram* telegram);
+        // Fills in payload length and value of the object
+        void copyValue(KnxGroupObject* object, KnxTelegram* telegram);
+
+    private:
+        byte _objects_by_index[MAX_LISTEN_GROUP_ADDRESSES];    // object + 1, 0 = none
+        KnxGroupObject _objects[MAX_GROUP_OBJECTS];
+        byte _count;
+};
+
+#endif
@@ -0,0 +1,61 @@
+#include "KnxMonitorBuffer.h"
+
+KnxMonitorBuffer::KnxMonitorBuffer() {
+    clear();
+}
+
+void KnxMonitorBuffer::clear() {
+    _head = 0;
+    _tail = 0;
+    _lost_pending = false;
+    _lost = 0;
+}
+
+KnxMonitorFrame* KnxMonitorBuffer::beginWrite() {
+    if ((byte) (_head - _tail) >= TPUART_MONITOR_BUFFER_SIZE) {
+        _lost++;
+        _lost_pending = true;
+        return 0;
+    }
+    return &_frames[_head & (TPUART_MONITOR_BUFFER_SIZE - 1)];
+}
+
+void KnxMonitorBuffer::commitWrite() {
+    if (_lost_pending) {
+        _frames[_head & (TPUART_MONITOR_BUFFER_SIZE - 1)].flags |= KNX_MONITOR_OVERFLOW;
+        _lost_pending = false;
+    }
+    _head = _head + 1;
+}
+
+int KnxMonitorBuffer::peek(const KnxMonitorFrame** frames) {
+    int first = _tail & (TPUART_MONITOR_BUFFER_SIZE - 1);
+    int count = (byte) (_head - _tail);
+    if (first + count > TPUART_MONITOR_BUFFER_SIZE) {
+        // Up to the end of the array, the rest with the next peek
+        count = TPUART_MONITOR_BUFFER_SIZE - first;
+    }
+    *frames = &_frames[first];
+    return count;
+}
+
+void KnxMonitorBuffer::release(int count) {
+    _tail = _tail + count;
+}
+
+int KnxMonitorBuffer::read(KnxMonitorFrame* frames, int max) {
+    int count = 0;
+    while (count < max && _head != _tail) {
+        frames[count++] = _frames[_tail & (TPUART_MONITOR_BUFFER_SIZE - 1)];
+        _tail = _tail + 1;
+    }
+    return count;
+}
+
+int KnxMonitorBuffer::getCount() {
+    return (byte) (_head - _tail);
+}
+
+unsigned long KnxMonitorBuffer::getLostCount() {
+    return _lost;
+}
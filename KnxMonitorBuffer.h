@@ -0,0 +1,72 @@
+#ifndef KnxMonitorBuffer_h
+#define KnxMonitorBuffer_h
+
+#include "Arduino.h"
+
+#include "KnxTelegram.h"
+
+// Number of frames the monitor buffer holds, must be a power of 2
+#ifndef TPUART_MONITOR_BUFFER_SIZE
+#define TPUART_MONITOR_BUFFER_SIZE 8
+#endif
+
+#if (TPUART_MONITOR_BUFFER_SIZE & (TPUART_MONITOR_BUFFER_SIZE - 1)) != 0 || TPUART_MONITOR_BUFFER_SIZE > 128
+#error "TPUART_MONITOR_BUFFER_SIZE must be a power of 2, at most 128"
+#endif
+
+// Flags of a monitored frame
+#define KNX_MONITOR_CHECKSUM_ERROR B0001
+#define KNX_MONITOR_TRUNCATED B0010     // gap inside the frame, length is what was received
+#define KNX_MONITOR_OVERFLOW B0100      // frames were lost before this one, the buffer was full
+#define KNX_MONITOR_ACK B1000           // acknowledge character on the bus (ACK, NACK, BUSY), 1 byte
+#define KNX_MONITOR_PARTIAL B10000      // extended frame longer than data, its first bytes
+
+// Acknowledge characters as seen in bus monitor mode
+#define KNX_BUS_ACK 0xCC
+#define KNX_BUS_NACK 0x0C
+#define KNX_BUS_BUSY 0xC0
+
+struct KnxMonitorFrame {
+    unsigned long time;     // micros() of the first byte
+    byte flags;             // KNX_MONITOR_*
+    byte length;            // stored in data
+    byte data[MAX_KNX_TELEGRAM_SIZE];
+
+    KnxTelegramView getView() const { return KnxTelegramView(data, length); }
+};
+
+/*
+ * Ring buffer of frames received in bus monitor mode, filled by
+ * KnxTpUart::serialEvent() and drained by the application in bulk.
+ * Nothing is overwritten: when the buffer is full, new frames are counted
+ * as lost and the next stored frame gets KNX_MONITOR_OVERFLOW.
+ */
+class KnxMonitorBuffer {
+    public:
+        KnxMonitorBuffer();
+
+        void clear();
+
+        // Producer: slot for the next frame, 0 if the buffer is full
+        KnxMonitorFrame* beginWrite();
+        void commitWrite();
+
+        // Consumer: frames stored in one piece from the oldest one on, without
+        // copying. Returns their number, release them when done.
+        int peek(const KnxMonitorFrame** frames);
+        void release(int count);
+        // Copies up to max frames and releases them
+        int read(KnxMonitorFrame* frames, int max);
+
+        int getCount();
+        unsigned long getLostCount();
+
+    private:
+        KnxMonitorFrame _frames[TPUART_MONITOR_BUFFER_SIZE];
+        volatile byte _head;    // written by the producer, free running
+        volatile byte _tail;    // written by the consumer, free running
+        bool _lost_pending;
+        unsigned long _lost;
+};
+
+#endif
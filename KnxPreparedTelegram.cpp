@@ -0,0 +1,73 @@
+#include "KnxPreparedTelegram.h"
+
+KnxPreparedTelegram::KnxPreparedTelegram() {
+    _checksumPos = _telegram.getTotalLength() - 1;
+}
+
+void KnxPreparedTelegram::prepare(byte sourceAddress[2], byte targetGroupAddress[2], KnxCommandType command, int payloadLength) {
+    _telegram.clear();
+    _telegram.setSourceAddress(sourceAddress);
+    _telegram.setTargetGroupAddress(targetGroupAddress);
+    _telegram.setCommand(command);
+    _telegram.setPayloadLength(payloadLength);
+    _telegram.createChecksum();
+
+    _checksumPos = _telegram.getTotalLength() - 1;
+}
+
+void KnxPreparedTelegram::prepare(KnxIndividualAddress sourceAddress, KnxGroupAddress targetGroupAddress, KnxCommandType command, int payloadLength) {
+    prepare(sourceAddress.getBytes(), targetGroupAddress.getBytes(), command, payloadLength);
+}
+
+/*
+ * DPT 1, value in the first data byte
+ */
+bool KnxPreparedTelegram::setBool(bool value) {
+    return setValue<Dpt<1> >(value);
+}
+
+/*
+ * DPT 4 / DPT 5
+ */
+bool KnxPreparedTelegram::set1ByteIntValue(int value) {
+    return setValue<Dpt<5> >(value);
+}
+
+/*
+ * DPT 9
+ */
+bool KnxPreparedTelegram::set2ByteFloatValue(float value) {
+    return setValue<Dpt<9> >(value);
+}
+
+/*
+ * DPT 14
+ */
+bool KnxPreparedTelegram::set4ByteFloatValue(float value) {
+    return setValue<Dpt<14> >(value);
+}
+
+bool KnxPreparedTelegram::setDataByte(int index, int content) {
+    if (index < 0 || index >= _checksumPos) {
+        return false;
+    }
+
+    byte oldContent = _telegram.getBufferByte(index);
+    _telegram.setBufferByte(index, content);
+    adjustChecksum(index, oldContent);
+    return true;
+}
+
+KnxTelegram* KnxPreparedTelegram::getTelegram() {
+    return &_telegram;
+}
+
+/*
+ * The checksum is the inverted XOR of all bytes, so a changed byte is
+ * accounted for by XOR'ing the old and the new content into it
+ */
+void KnxPreparedTelegram::adjustChecksum(int index, byte oldContent) {
+    byte checksum = _telegram.getBufferByte(_checksumPos);
+    checksum ^= oldContent ^ _telegram.getBufferByte(index);
+    _telegram.setBufferByte(_checksumPos, checksum);
+}
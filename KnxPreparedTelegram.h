@@ -0,0 +1,62 @@
+#ifndef KnxPreparedTelegram_h
+#define KnxPreparedTelegram_h
+
+#include "Arduino.h"
+
+#include "KnxTelegram.h"
+
+/*
+ * Telegram for periodic sending to the same group address: header and
+ * checksum are built once, setting a new value only touches the data bytes
+ * and adjusts the checksum for the bytes that changed.
+ */
+class KnxPreparedTelegram {
+    public:
+        KnxPreparedTelegram();
+
+        // payloadLength as in KnxTelegram::setPayloadLength, must match the value
+        // setter used later: 2 for setBool, 3 for 1 byte, 4 for DPT 9, 6 for DPT 14
+        void prepare(byte* sourceAddress, byte* targetGroupAddress, KnxCommandType command, int payloadLength);
+        void prepare(KnxIndividualAddress sourceAddress, KnxGroupAddress targetGroupAddress, KnxCommandType command, int payloadLength);
+        // Payload length of a DPT, e.g. prepare<Dpt<9> >(...) for setValue<Dpt<9> >
+        template<class D> void prepare(KnxIndividualAddress sourceAddress, KnxGroupAddress targetGroupAddress, KnxCommandType command) {
+            prepare(sourceAddress, targetGroupAddress, command, D::PAYLOAD_LENGTH);
+        }
+
+        // False, with the telegram unchanged, if it was prepared for another
+        // payload length
+        bool setBool(bool value);
+        bool set1ByteIntValue(int value);
+        bool set2ByteFloatValue(float value);
+        bool set4ByteFloatValue(float value);
+        // Header and data bytes only, false for the checksum and beyond
+        bool setDataByte(int index, int content);
+
+        // Any DPT, e.g. setValue<Dpt<9> >(21.5)
+        template<class D> bool setValue(const typename D::Type& value) {
+            if (_telegram.getPayloadLength() != D::PAYLOAD_LENGTH) {
+                return false;
+            }
+
+            // Encode into a copy of the data bytes, then update the changed ones
+            byte data[D::SIZE + 1];
+            for (int i = 0; i <= D::SIZE; i++) {
+                data[i] = _telegram.getBufferByte(7 + i);
+            }
+            D::encode(value, data);
+            for (int i = 0; i <= D::SIZE; i++) {
+                setDataByte(7 + i, data[i]);
+            }
+            return true;
+        }
+
+        KnxTelegram* getTelegram();
+
+    private:
+        KnxTelegram _telegram;
+        int _checksumPos;
+
+        void adjustChecksum(int index, byte oldContent);
+};
+
+#endif
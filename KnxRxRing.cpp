@@ -0,0 +1,70 @@
+#include "KnxRxRing.h"
+
+KnxRxRing::KnxRxRing() {
+    clear();
+}
+
+void KnxRxRing::clear() {
+    _head = 0;
+    _tail = 0;
+    _lost = 0;
+}
+
+void KnxRxRing::push(byte data) {
+    push(data, micros());
+}
+
+void KnxRxRing::push(byte data, unsigned long time) {
+    byte head = _head;
+    if ((byte) (head - _tail) >= TPUART_RX_RING_SIZE) {
+        _lost = _lost + 1;
+        return;
+    }
+    // Not stored before the consumer released the place
+    TPUART_RX_RING_BARRIER();
+
+    _data[head & (TPUART_RX_RING_SIZE - 1)] = data;
+    _times[head & (TPUART_RX_RING_SIZE - 1)] = KnxRxRing::time(time);
+    // Published after the byte is stored
+    TPUART_RX_RING_BARRIER();
+    _head = head + 1;
+}
+
+void KnxRxRing::fill(Stream* stream) {
+    unsigned long now = micros();
+    while (stream->available() > 0) {
+        push(stream->read(), now);
+    }
+}
+
+int KnxRxRing::peek(const byte** data, const uint16_t** times) {
+    byte tail = _tail;
+    int first = tail & (TPUART_RX_RING_SIZE - 1);
+    int count = (byte) (_head - tail);
+    // The bytes are read after the producer published them
+    TPUART_RX_RING_BARRIER();
+    if (first + count > TPUART_RX_RING_SIZE) {
+        // Up to the end of the array, the rest with the next peek
+        count = TPUART_RX_RING_SIZE - first;
+    }
+    *data = &_data[first];
+    *times = &_times[first];
+    return count;
+}
+
+void KnxRxRing::release(int count) {
+    // Done with the bytes before the producer may overwrite them
+    TPUART_RX_RING_BARRIER();
+    _tail = _tail + count;
+}
+
+int KnxRxRing::getCount() {
+    return (byte) (_head - _tail);
+}
+
+unsigned long KnxRxRing::getLostCount() {
+    noInterrupts();
+    unsigned long lost = _lost;
+    interrupts();
+    return lost;
+}
@@ -0,0 +1,77 @@
+#ifndef KnxRxRing_h
+#define KnxRxRing_h
+
+#include "Arduino.h"
+
+// Number of bytes the ring holds, must be a power of 2. 128 bytes hold
+// about 100 ms of a fully loaded bus.
+#ifndef TPUART_RX_RING_SIZE
+#define TPUART_RX_RING_SIZE 128
+#endif
+
+#if (TPUART_RX_RING_SIZE & (TPUART_RX_RING_SIZE - 1)) != 0 || TPUART_RX_RING_SIZE > 128
+#error "TPUART_RX_RING_SIZE must be a power of 2, at most 128"
+#endif
+
+// Silence between two bytes that ends a frame: bytes of a frame follow each
+// other every 1.35 ms on the bus, frames are at least 50 bit times apart
+#ifndef TPUART_RX_GAP_US
+#define TPUART_RX_GAP_US 4000
+#endif
+
+// A header read later than this after its last byte arrived is not
+// acknowledged any more, the TPUART has passed the point for it
+#ifndef TPUART_RX_ACK_WINDOW_US
+#define TPUART_RX_ACK_WINDOW_US 1500
+#endif
+
+// Times of the bytes wrap after this, about 1 s
+#define TPUART_RX_RING_TIME_WRAP_US (65536UL * 16)
+
+// Keeps the compiler from moving accesses to the bytes across the update of
+// an index. The producer is an interrupt on the same core, the CPU itself
+// doesn't reorder them.
+#define TPUART_RX_RING_BARRIER() asm volatile("" ::: "memory")
+
+/*
+ * Bytes received from the TPUART with the time they arrived, filled from
+ * an interrupt and drained by KnxTpUart::serialEvent(). One producer and
+ * one consumer, no locking: each side only writes its own index, and the
+ * indexes are single bytes. A byte that doesn't fit is dropped and counted.
+ *
+ * Times are micros() / 16 in 16 bit, they wrap after about 1 s.
+ */
+class KnxRxRing {
+    public:
+        KnxRxRing();
+
+        void clear();
+
+        // Producer, e.g. in the receive interrupt of the UART
+        void push(byte data);
+        void push(byte data, unsigned long time);
+        // Moves the bytes available on the stream, e.g. from a timer interrupt
+        void fill(Stream* stream);
+
+        // Consumer: bytes stored in one piece from the oldest one on and their
+        // times, without copying. Returns their number, release them when done.
+        int peek(const byte** data, const uint16_t** times);
+        void release(int count);
+
+        int getCount();
+        // Read with interrupts disabled, it takes more than one load on AVR
+        unsigned long getLostCount();
+
+        static uint16_t time(unsigned long micros) {
+            return micros >> 4;
+        }
+
+    private:
+        byte _data[TPUART_RX_RING_SIZE];
+        uint16_t _times[TPUART_RX_RING_SIZE];
+        volatile byte _head;    // written by the producer, free running
+        volatile byte _tail;    // written by the consumer, free running
+        volatile unsigned long _lost;
+};
+
+#endif
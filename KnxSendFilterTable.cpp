@@ -0,0 +1,100 @@
+#include "KnxSendFilterTable.h"
+
+KnxSendFilterTable::KnxSendFilterTable() {
+    clear();
+}
+
+void KnxSendFilterTable::clear() {
+    _count = 0;
+}
+
+bool KnxSendFilterTable::add(KnxGroupAddress groupAddress, unsigned int minInterval, float threshold, KnxSendFilterDecode decode) {
+    KnxSendFilter* filter = 0;
+    for (int i = 0; i < _count; i++) {
+        if (_filters[i].groupAddress == groupAddress.getValue()) {
+            filter = &_filters[i];
+            break;
+        }
+    }
+
+    if (filter == 0) {
+        if (_count >= MAX_SEND_FILTERS) {
+            return false;
+        }
+        filter = &_filters[_count++];
+        filter->groupAddress = groupAddress.getValue();
+        filter->flags = 0;
+        filter->held = 0;
+    }
+
+    filter->minInterval = minInterval;
+    filter->threshold = threshold;
+    filter->decode = decode;
+    return true;
+}
+
+KnxSendFilter* KnxSendFilterTable::find(KnxTelegram* telegram) {
+    if (_count == 0 || !telegram->isTargetGroup() || telegram->getCommand() != KNX_COMMAND_WRITE) {
+        return 0;
+    }
+
+    uint16_t groupAddress = telegram->getTargetGroupAddress().getValue();
+    for (int i = 0; i < _count; i++) {
+        if (_filters[i].groupAddress == groupAddress) {
+            return &_filters[i];
+        }
+    }
+    return 0;
+}
+
+bool KnxSendFilterTable::isChanged(KnxSendFilter* filter, KnxTelegram* telegram) {
+    if (filter->decode == 0 || !(filter->flags & KNX_SEND_FILTER_SENT)) {
+        return true;
+    }
+
+    byte data[MAX_KNX_TELEGRAM_SIZE - 7];
+    for (int i = 0; i < (int) sizeof(data); i++) {
+        data[i] = telegram->getBufferByte(7 + i);
+    }
+    float difference = filter->decode(data) - filter->lastValue;
+    return difference >= filter->threshold || -difference >= filter->threshold;
+}
+
+bool KnxSendFilterTable::isDue(KnxSendFilter* filter) {
+    return !(filter->flags & KNX_SEND_FILTER_SENT) || millis() - filter->lastTime >= filter->minInterval;
+}
+
+KnxTelegram* KnxSendFilterTable::hold(KnxSendFilter* filter, KnxTelegram* telegram, KnxTxCallback callback, void* context) {
+    KnxTelegram* replaced = filter->held;
+    filter->held = telegram;
+    filter->heldCallback = callback;
+    filter->heldCallbackContext = context;
+    return replaced;
+}
+
+KnxTelegram* KnxSendFilterTable::takeHeld(KnxSendFilter* filter) {
+    KnxTelegram* held = filter->held;
+    filter->held = 0;
+    return held;
+}
+
+void KnxSendFilterTable::sent(KnxSendFilter* filter, KnxTelegram* telegram) {
+    filter->lastTime = millis();
+    if (filter->decode != 0) {
+        byte data[MAX_KNX_TELEGRAM_SIZE - 7];
+        for (int i = 0; i < (int) sizeof(data); i++) {
+            data[i] = telegram->getBufferByte(7 + i);
+        }
+        filter->lastValue = filter->decode(data);
+    }
+    filter->flags |= KNX_SEND_FILTER_SENT;
+}
+
+KnxSendFilter* KnxSendFilterTable::findDue() {
+    for (int i = 0; i < _count; i++) {
+        if (_filters[i].held != 0 && isDue(&_filters[i])) {
+            return &_filters[i];
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,75 @@
+#ifndef KnxSendFilterTable_h
+#define KnxSendFilterTable_h
+
+#include "Arduino.h"
+
+#include "KnxTelegram.h"
+#include "KnxTxCallback.h"
+
+// Maximum number of group addresses with a send filter
+#ifndef MAX_SEND_FILTERS
+#define MAX_SEND_FILTERS 8
+#endif
+
+#if MAX_SEND_FILTERS > 255
+#error "MAX_SEND_FILTERS must be at most 255"
+#endif
+
+// Flags of a send filter
+#define KNX_SEND_FILTER_SENT B0001      // lastTime and lastValue are set
+
+// Value of a telegram as number, from the APCI byte on
+typedef float (*KnxSendFilterDecode)(const byte* data);
+
+/*
+ * Writes to one group address: at most one per minInterval, and with decode
+ * only when the value moved by at least threshold since it was last sent.
+ * A write that comes too early is held, a later one replaces it. The held
+ * telegram stays leased from the pool until it is queued or dropped.
+ */
+struct KnxSendFilter {
+    uint16_t groupAddress;
+    byte flags;
+    unsigned int minInterval;       // ms
+    float threshold;
+    KnxSendFilterDecode decode;     // 0: every value counts as changed
+    unsigned long lastTime;         // millis() the last value was queued
+    float lastValue;
+    KnxTelegram* held;              // waits for the interval, 0 if none
+    KnxTxCallback heldCallback;
+    void* heldCallbackContext;
+};
+
+class KnxSendFilterTable {
+    public:
+        KnxSendFilterTable();
+
+        void clear();
+
+        // Returns false if the table is full, replaces an existing filter
+        bool add(KnxGroupAddress groupAddress, unsigned int minInterval, float threshold, KnxSendFilterDecode decode);
+        // Filter for a group write, 0 if it has none
+        KnxSendFilter* find(KnxTelegram* telegram);
+
+        bool isChanged(KnxSendFilter* filter, KnxTelegram* telegram);
+        bool isDue(KnxSendFilter* filter);
+        // Returns the telegram held before, 0 if none; the caller releases it
+        KnxTelegram* hold(KnxSendFilter* filter, KnxTelegram* telegram, KnxTxCallback callback, void* context);
+        // The held telegram is given up to the caller, 0 if none
+        KnxTelegram* takeHeld(KnxSendFilter* filter);
+        // The telegram was queued, a held one must have been taken
+        void sent(KnxSendFilter* filter, KnxTelegram* telegram);
+        // First held telegram whose interval is over, 0 if there is none
+        KnxSendFilter* findDue();
+
+        // For add<D>(): the DPT value as number
+        template<class D> static float decodeValue(const byte* data) {
+            return D::decode(data);
+        }
+
+    private:
+        KnxSendFilter _filters[MAX_SEND_FILTERS];
+        byte _count;
+};
+
+#endif
@@ -1,167 +1,320 @@
-#ifndef KnxTelegram_h
-#define KnxTelegram_h
-
-#include "Arduino.h"
-
-#define MAX_KNX_TELEGRAM_SIZE 23
-#define KNX_TELEGRAM_HEADER_SIZE 6
-
-#define TPUART_SERIAL_CLASS Stream
-
-// KNX priorities
-enum KnxPriorityType {
-    KNX_PRIORITY_SYSTEM = B00,
-    KNX_PRIORITY_ALARM = B10,
-    KNX_PRIORITY_HIGH = B01,
-    KNX_PRIORITY_NORMAL = B11
-};
-
-// KNX commands / APCI Coding
-// see: http://www.mikrocontroller.net/attachment/151008/KNX_Twisted_Pair_Protokollbeschreibung.pdf
-enum KnxCommandType {
-    KNX_COMMAND_READ                     = B0000,
-    KNX_COMMAND_ANSWER                   = B0001,
-    KNX_COMMAND_WRITE                    = B0010,
-    KNX_COMMAND_INDIVIDUAL_ADDR_WRITE    = B0011,
-    KNX_COMMAND_INDIVIDUAL_ADDR_REQUEST  = B0100,
-    KNX_COMMAND_INDIVIDUAL_ADDR_RESPONSE = B0101,
-    KNX_COMMAND_ADC_READ                 = B0110,
-    KNX_COMMAND_ADC_ANSWER               = B0111,
-    KNX_COMMAND_MEM_READ                 = B1000, //(CC)
-    KNX_COMMAND_MEM_ANSWER               = B1001, //(CC)
-    KNX_COMMAND_MEM_WRITE                = B1010, //(CC) 
-    KNX_COMMAND_MASK_VERSION_READ        = B1100,
-    KNX_COMMAND_MASK_VERSION_RESPONSE    = B1101,
-    KNX_COMMAND_RESTART                  = B1110,
-    KNX_COMMAND_ESCAPE                   = B1111
-};
-
-// Extended (escaped) KNX commands
-// requires KNX_COMMAND_ESCAPE
-// see: http://www.mikrocontroller.net/attachment/151008/KNX_Twisted_Pair_Protokollbeschreibung.pdf
-enum KnxExtendedCommandType {
-    KNX_EXT_COMMAND_PROP_READ        = B010101, 
-    KNX_EXT_COMMAND_PROP_ANSWER      = B010110,
-    KNX_EXT_COMMAND_PROP_WRITE       = B010111,
-    KNX_EXT_COMMAND_PROP_DESC_READ   = B011000,
-    KNX_EXT_COMMAND_PROP_DESC_ANSWER = B011001,
-    KNX_EXT_COMMAND_AUTH_REQUEST     = B010001,
-    KNX_EXT_COMMAND_AUTH_RESPONSE    = B010010 
-};
-
-// KNX Transport Layer Communication Type
-enum KnxCommunicationType {
-    KNX_COMM_UDP = B00, // Unnumbered Data Packet
-    KNX_COMM_NDP = B01, // Numbered Data Packet
-    KNX_COMM_UCD = B10, // Unnumbered Control Data
-    KNX_COMM_NCD = B11  // Numbered Control Data
-};
-
-// KNX Control Data (for UCD / NCD packets)
-enum KnxControlDataType {
-    KNX_CONTROLDATA_CONNECT = B00,      // UCD
-    KNX_CONTROLDATA_DISCONNECT = B01,   // UCD
-    KNX_CONTROLDATA_POS_CONFIRM = B10,  // NCD
-    KNX_CONTROLDATA_NEG_CONFIRM = B11   // NCD
-};
-
-class KnxTelegram {
-    public:
-        KnxTelegram();
-        
-        void clear();
-        void setBufferByte(int index, int content);
-        int getBufferByte(int index);
-        void setPayloadLength(int size);
-        int getPayloadLength();
-        void setRepeated(bool repeat);
-        bool isRepeated();
-        void setPriority(KnxPriorityType prio);
-        KnxPriorityType getPriority();
-        
-        void setSourceAddress(byte* sourceAddress);
-        int getSourceArea();
-        int getSourceLine();
-        int getSourceMember();
-        
-        void setTargetGroupAddress(byte* targetGroupAddress);
-        int getTargetMainGroup();
-        int getTargetMiddleGroup();
-        int getTargetSubGroup();
-        
-        void setTargetIndividualAddress(byte* targetIndividualAddress);
-        int getTargetArea();
-        int getTargetLine();
-        int getTargetMember();
-        
-        void getTarget(byte* target); // returns individualaddress target style
-        void getTargetGroup(byte* target); // returns groupaddress target style
-        
-        bool isTargetGroup();
-        bool isBroadcast();
-        
-        void setRoutingCounter(int counter);
-        int getRoutingCounter();
-        
-        void setCommand(KnxCommandType command);
-        KnxCommandType getCommand();
-        
-        void setExtendedCommand(KnxExtendedCommandType command);
-        KnxExtendedCommandType getExtendedCommand();
-        
-        void createChecksum();
-        bool verifyChecksum();
-        int getChecksum();
-        void print(TPUART_SERIAL_CLASS*);
-        int getTotalLength();
-        KnxCommunicationType getCommunicationType();
-        void setCommunicationType(KnxCommunicationType);
-        
-        int getSequenceNumber();
-        void setSequenceNumber(int);
-        
-        void setControlData(KnxControlDataType);
-        KnxControlDataType getControlData();
-
-        
-        // Getter+Setter for DPTs
-        void setFirstDataByte(int data);
-        int getFirstDataByte();
-        bool getBool();
-        
-        void set2ByteFloatValue(float value);
-        float get2ByteFloatValue();
-        
-        void set2ByteIntValue(float value);
-        int get1ByteIntValue();
-        
-        void set1ByteIntValue(int value);
-        float get2ByteIntValue();
-        
-        void set4ByteFloatValue(float value);
-        float get4ByteFloatValue();
-        
-        void setKNXTime(int day, int hours, int minutes, int seconds);
-        
-        void set14ByteValue(String value);
-        String get14ByteValue(String value);
-
-        // Getter+Setter for Properties/Memory Access
-//    int curr_object;
-//    int curr_property; 
-//    int curr_length = 2;
-//    byte curr_data[curr_length];
-        int getPropertyObject();
-        int getPropertyId();
-        int getPropertyCount();
-        void getPropertyData(byte* data);
-        
-
-    private:
-        int buffer[MAX_KNX_TELEGRAM_SIZE];
-        int calculateChecksum();
-
-};
-
-#endif
-
+#ifndef KnxTelegram_h
+#define KnxTelegram_h
+
+#include "Arduino.h"
+
+#include "KnxAddress.h"
+#include "KnxDpt.h"
+
+#define MAX_KNX_TELEGRAM_SIZE 23
+#define KNX_TELEGRAM_HEADER_SIZE 6
+
+// L_Data extended frames: one more header byte, payload (TPCI, APCI and
+// data) up to 255 bytes
+#define MAX_KNX_EXTENDED_PAYLOAD_LENGTH 255
+#define KNX_EXTENDED_TELEGRAM_HEADER_SIZE 7
+#define MAX_KNX_EXTENDED_TELEGRAM_SIZE (KNX_EXTENDED_TELEGRAM_HEADER_SIZE + MAX_KNX_EXTENDED_PAYLOAD_LENGTH + 1)
+
+#define TPUART_SERIAL_CLASS Stream
+
+// KNX priorities
+enum KnxPriorityType {
+    KNX_PRIORITY_SYSTEM = B00,
+    KNX_PRIORITY_ALARM = B10,
+    KNX_PRIORITY_HIGH = B01,
+    KNX_PRIORITY_NORMAL = B11
+};
+
+// KNX commands / APCI Coding
+// see: http://www.mikrocontroller.net/attachment/151008/KNX_Twisted_Pair_Protokollbeschreibung.pdf
+enum KnxCommandType {
+    KNX_COMMAND_READ                     = B0000,
+    KNX_COMMAND_ANSWER                   = B0001,
+    KNX_COMMAND_WRITE                    = B0010,
+    KNX_COMMAND_INDIVIDUAL_ADDR_WRITE    = B0011,
+    KNX_COMMAND_INDIVIDUAL_ADDR_REQUEST  = B0100,
+    KNX_COMMAND_INDIVIDUAL_ADDR_RESPONSE = B0101,
+    KNX_COMMAND_ADC_READ                 = B0110,
+    KNX_COMMAND_ADC_ANSWER               = B0111,
+    KNX_COMMAND_MEM_READ                 = B1000, //(CC)
+    KNX_COMMAND_MEM_ANSWER               = B1001, //(CC)
+    KNX_COMMAND_MEM_WRITE                = B1010, //(CC) 
+    KNX_COMMAND_MASK_VERSION_READ        = B1100,
+    KNX_COMMAND_MASK_VERSION_RESPONSE    = B1101,
+    KNX_COMMAND_RESTART                  = B1110,
+    KNX_COMMAND_ESCAPE                   = B1111
+};
+
+// Extended (escaped) KNX commands
+// requires KNX_COMMAND_ESCAPE
+// see: http://www.mikrocontroller.net/attachment/151008/KNX_Twisted_Pair_Protokollbeschreibung.pdf
+enum KnxExtendedCommandType {
+    KNX_EXT_COMMAND_PROP_READ        = B010101, 
+    KNX_EXT_COMMAND_PROP_ANSWER      = B010110,
+    KNX_EXT_COMMAND_PROP_WRITE       = B010111,
+    KNX_EXT_COMMAND_PROP_DESC_READ   = B011000,
+    KNX_EXT_COMMAND_PROP_DESC_ANSWER = B011001,
+    KNX_EXT_COMMAND_AUTH_REQUEST     = B010001,
+    KNX_EXT_COMMAND_AUTH_RESPONSE    = B010010 
+};
+
+// KNX Transport Layer Communication Type
+enum KnxCommunicationType {
+    KNX_COMM_UDP = B00, // Unnumbered Data Packet
+    KNX_COMM_NDP = B01, // Numbered Data Packet
+    KNX_COMM_UCD = B10, // Unnumbered Control Data
+    KNX_COMM_NCD = B11  // Numbered Control Data
+};
+
+// KNX Control Data (for UCD / NCD packets)
+enum KnxControlDataType {
+    KNX_CONTROLDATA_CONNECT = B00,      // UCD
+    KNX_CONTROLDATA_DISCONNECT = B01,   // UCD
+    KNX_CONTROLDATA_POS_CONFIRM = B10,  // NCD
+    KNX_CONTROLDATA_NEG_CONFIRM = B11   // NCD
+};
+
+/*
+ * Read-only access to a telegram stored in an arbitrary byte span (receive
+ * buffer, ring buffer, capture file, ...) without copying it.
+ * The bytes must stay valid as long as the view is used.
+ * Standard and extended frames, told apart by the control byte.
+ */
+class KnxTelegramView {
+    public:
+        KnxTelegramView(const byte* data, int length = MAX_KNX_TELEGRAM_SIZE);
+
+        bool isComplete() const;
+        bool isExtended() const;
+        int getHeaderSize() const;
+        const byte* getBuffer() const;
+        int getBufferByte(int index) const;
+        int getPayloadLength() const;
+        bool isRepeated() const;
+        KnxPriorityType getPriority() const;
+
+        int getSourceArea() const;
+        int getSourceLine() const;
+        int getSourceMember() const;
+
+        int getTargetMainGroup() const;
+        int getTargetMiddleGroup() const;
+        int getTargetSubGroup() const;
+
+        int getTargetArea() const;
+        int getTargetLine() const;
+        int getTargetMember() const;
+
+        void getTarget(byte* target) const; // returns individualaddress target style
+
+        KnxIndividualAddress getSourceAddress() const;
+        KnxGroupAddress getTargetGroupAddress() const;
+        KnxIndividualAddress getTargetIndividualAddress() const;
+
+        bool isTargetGroup() const;
+        bool isBroadcast() const;
+
+        int getRoutingCounter() const;
+        KnxCommandType getCommand() const;
+        KnxExtendedCommandType getExtendedCommand() const;
+
+        // -1 if the span ends before the checksum
+        int calculateChecksum() const;
+        // False too if the span ends before the checksum
+        bool verifyChecksum() const;
+        // -1 if the span ends before the checksum
+        int getChecksum() const;
+        void print(TPUART_SERIAL_CLASS*) const;
+        int getTotalLength() const;
+        KnxCommunicationType getCommunicationType() const;
+        int getSequenceNumber() const;
+        KnxControlDataType getControlData() const;
+
+        // Getters for DPTs
+        int getFirstDataByte() const;
+        bool getBool() const;
+        float get2ByteFloatValue() const;
+        int get2ByteIntValue() const;
+        int get1ByteIntValue() const;
+        float get4ByteFloatValue() const;
+        String get14ByteValue(String value) const;
+
+        // Any DPT, e.g. getValue<Dpt<9> >()
+        template<class D> typename D::Type getValue() const {
+            return D::decode(&_data[7 + offset()]);
+        }
+
+    private:
+        const byte* _data;
+        int _length;
+
+        // Extended frames have the fields behind the control byte one byte later
+        int offset() const {
+            return (_data[0] & B10000000) ? 0 : 1;
+        }
+};
+
+class KnxTelegram {
+    public:
+        KnxTelegram();
+        
+        void clear();
+        // Read-only view on the buffer of this telegram
+        KnxTelegramView getView();
+        void setBufferByte(int index, int content);
+        int getBufferByte(int index);
+        void setPayloadLength(int size);
+        int getPayloadLength();
+        void setRepeated(bool repeat);
+        bool isRepeated();
+        void setPriority(KnxPriorityType prio);
+        KnxPriorityType getPriority();
+        
+        void setSourceAddress(byte* sourceAddress);
+        void setSourceAddress(KnxIndividualAddress sourceAddress);
+        KnxIndividualAddress getSourceAddress();
+        int getSourceArea();
+        int getSourceLine();
+        int getSourceMember();
+        
+        void setTargetGroupAddress(byte* targetGroupAddress);
+        void setTargetGroupAddress(KnxGroupAddress targetGroupAddress);
+        KnxGroupAddress getTargetGroupAddress();
+        int getTargetMainGroup();
+        int getTargetMiddleGroup();
+        int getTargetSubGroup();
+        
+        void setTargetIndividualAddress(byte* targetIndividualAddress);
+        void setTargetIndividualAddress(KnxIndividualAddress targetIndividualAddress);
+        KnxIndividualAddress getTargetIndividualAddress();
+        int getTargetArea();
+        int getTargetLine();
+        int getTargetMember();
+        
+        void getTarget(byte* target); // returns individualaddress target style
+        void getTargetGroup(byte* target); // returns groupaddress target style
+        
+        bool isTargetGroup();
+        bool isBroadcast();
+        
+        void setRoutingCounter(int counter);
+        int getRoutingCounter();
+        
+        void setCommand(KnxCommandType command);
+        KnxCommandType getCommand();
+        
+        void setExtendedCommand(KnxExtendedCommandType command);
+        KnxExtendedCommandType getExtendedCommand();
+        
+        // Does nothing if the telegram doesn't fit MAX_KNX_TELEGRAM_SIZE,
+        // e.g. with the frame type bit of an extended frame in byte 0
+        void createChecksum();
+        bool verifyChecksum();
+        int getChecksum();
+        void print(TPUART_SERIAL_CLASS*);
+        int getTotalLength();
+        KnxCommunicationType getCommunicationType();
+        void setCommunicationType(KnxCommunicationType);
+        
+        int getSequenceNumber();
+        void setSequenceNumber(int);
+        
+        void setControlData(KnxControlDataType);
+        KnxControlDataType getControlData();
+
+        
+        // Getter+Setter for DPTs
+        void setFirstDataByte(int data);
+        int getFirstDataByte();
+        bool getBool();
+        
+        void set2ByteFloatValue(float value);
+        float get2ByteFloatValue();
+        
+        void set2ByteIntValue(int value);
+        int get2ByteIntValue();
+
+        void set1ByteIntValue(int value);
+        int get1ByteIntValue();
+        
+        void set4ByteFloatValue(float value);
+        float get4ByteFloatValue();
+        
+        void setKNXTime(int day, int hours, int minutes, int seconds);
+        
+        void set14ByteValue(String value);
+        String get14ByteValue(String value);
+
+        // Any DPT, e.g. setValue<Dpt<5, 1> >(50) for 50%
+        template<class D> void setValue(const typename D::Type& value) {
+            setPayloadLength(D::PAYLOAD_LENGTH);
+            D::encode(value, &buffer[7]);
+        }
+
+        template<class D> typename D::Type getValue() {
+            return getView().getValue<D>();
+        }
+
+        // Getter+Setter for Properties/Memory Access
+//    int curr_object;
+//    int curr_property; 
+//    int curr_length = 2;
+//    byte curr_data[curr_length];
+        int getPropertyObject();
+        int getPropertyId();
+        int getPropertyCount();
+        void getPropertyData(byte* data);
+        
+
+    private:
+        byte buffer[MAX_KNX_TELEGRAM_SIZE];
+
+};
+
+/*
+ * L_Data extended frame, for memory and property accesses that don't fit
+ * into a standard frame. The address type and routing counter move into
+ * an extra control byte, the payload length into a byte of its own.
+ * Takes MAX_KNX_EXTENDED_TELEGRAM_SIZE bytes, read it with getView().
+ */
+class KnxExtendedTelegram {
+    public:
+        KnxExtendedTelegram();
+
+        void clear();
+        KnxTelegramView getView();
+        const byte* getBuffer();
+        // Beyond MAX_KNX_EXTENDED_TELEGRAM_SIZE ignored, read as 0
+        void setBufferByte(int index, int content);
+        int getBufferByte(int index);
+        // TPCI, APCI and data, limited to 2 to MAX_KNX_EXTENDED_PAYLOAD_LENGTH
+        void setPayloadLength(int length);
+        int getPayloadLength();
+        void setRepeated(bool repeat);
+        void setPriority(KnxPriorityType prio);
+        KnxPriorityType getPriority();
+
+        void setSourceAddress(KnxIndividualAddress sourceAddress);
+        void setTargetGroupAddress(KnxGroupAddress targetGroupAddress);
+        void setTargetIndividualAddress(KnxIndividualAddress targetIndividualAddress);
+        bool isTargetGroup();
+        void setRoutingCounter(int counter);
+
+        void setCommand(KnxCommandType command);
+        void setExtendedCommand(KnxExtendedCommandType command);
+        void setCommunicationType(KnxCommunicationType type);
+        void setSequenceNumber(int number);
+        void setFirstDataByte(int data);
+        // Bytes after the APCI, sets the payload length
+        void setData(const byte* data, int length);
+
+        void createChecksum();
+        bool verifyChecksum();
+        int getTotalLength();
+
+    private:
+        byte buffer[MAX_KNX_EXTENDED_TELEGRAM_SIZE];
+};
+
+#endif
+
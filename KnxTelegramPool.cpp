@@ -0,0 +1,110 @@
+#include "KnxTelegramPool.h"
+
+// Values of _next besides indexes
+#define KNX_TELEGRAM_POOL_END 0xFF
+#define KNX_TELEGRAM_POOL_LEASED 0xFE
+
+KnxTelegramPool::KnxTelegramPool() {
+    clear();
+}
+
+void KnxTelegramPool::clear() {
+    link(_next, TPUART_TELEGRAM_POOL_SIZE, &_free, &_free_count);
+#if TPUART_EXTENDED_TELEGRAM_POOL_SIZE > 0
+    link(_extended_next, TPUART_EXTENDED_TELEGRAM_POOL_SIZE, &_extended_free, &_extended_free_count);
+#else
+    link(0, 0, &_extended_free, &_extended_free_count);
+#endif
+    _exhausted = 0;
+}
+
+KnxTelegram* KnxTelegramPool::allocate() {
+    int index = take(_next, &_free, &_free_count);
+    if (index < 0) {
+        return 0;
+    }
+
+    _telegrams[index].clear();
+    return &_telegrams[index];
+}
+
+KnxExtendedTelegram* KnxTelegramPool::allocateExtended() {
+#if TPUART_EXTENDED_TELEGRAM_POOL_SIZE > 0
+    int index = take(_extended_next, &_extended_free, &_extended_free_count);
+    if (index < 0) {
+        return 0;
+    }
+
+    _extended[index].clear();
+    return &_extended[index];
+#else
+    _exhausted++;
+    return 0;
+#endif
+}
+
+void KnxTelegramPool::release(KnxTelegram* telegram) {
+    if (telegram < &_telegrams[0] || telegram >= &_telegrams[TPUART_TELEGRAM_POOL_SIZE]) {
+        return;
+    }
+    put(_next, telegram - _telegrams, &_free, &_free_count);
+}
+
+void KnxTelegramPool::release(KnxExtendedTelegram* telegram) {
+#if TPUART_EXTENDED_TELEGRAM_POOL_SIZE > 0
+    if (telegram < &_extended[0] || telegram >= &_extended[TPUART_EXTENDED_TELEGRAM_POOL_SIZE]) {
+        return;
+    }
+    put(_extended_next, telegram - _extended, &_extended_free, &_extended_free_count);
+#endif
+}
+
+int KnxTelegramPool::getFreeCount() {
+    return _free_count;
+}
+
+int KnxTelegramPool::getExtendedFreeCount() {
+    return _extended_free_count;
+}
+
+unsigned long KnxTelegramPool::getExhaustedCount() {
+    return _exhausted;
+}
+
+/*
+ * All indexes of a size class free, in order
+ */
+void KnxTelegramPool::link(byte* next, int size, byte* free, byte* freeCount) {
+    for (int i = 0; i < size; i++) {
+        next[i] = i + 1 < size ? i + 1 : KNX_TELEGRAM_POOL_END;
+    }
+    *free = size > 0 ? 0 : KNX_TELEGRAM_POOL_END;
+    *freeCount = size;
+}
+
+/*
+ * First free index of a size class, -1 if there is none
+ */
+int KnxTelegramPool::take(byte* next, byte* free, byte* freeCount) {
+    if (*free == KNX_TELEGRAM_POOL_END) {
+        _exhausted++;
+        return -1;
+    }
+
+    byte index = *free;
+    *free = next[index];
+    next[index] = KNX_TELEGRAM_POOL_LEASED;
+    (*freeCount)--;
+    return index;
+}
+
+void KnxTelegramPool::put(byte* next, int index, byte* free, byte* freeCount) {
+    if (next[index] != KNX_TELEGRAM_POOL_LEASED) {
+        // Released twice
+        return;
+    }
+
+    next[index] = *free;
+    *free = index;
+    (*freeCount)++;
+}
@@ -0,0 +1,76 @@
+#ifndef KnxTelegramPool_h
+#define KnxTelegramPool_h
+
+#include "Arduino.h"
+
+#include "KnxTelegram.h"
+
+// Number of telegrams shared by receiving, the transmit queue and the
+// application. Each queued telegram holds one, the received telegram one,
+// and every telegram the application took and did not release yet.
+#ifndef TPUART_TELEGRAM_POOL_SIZE
+#define TPUART_TELEGRAM_POOL_SIZE 8
+#endif
+
+#if TPUART_TELEGRAM_POOL_SIZE < 2 || TPUART_TELEGRAM_POOL_SIZE > 250
+#error "TPUART_TELEGRAM_POOL_SIZE must be 2 to 250"
+#endif
+
+// Number of extended telegrams, the size class for extended frames. Each
+// takes MAX_KNX_EXTENDED_TELEGRAM_SIZE bytes, so there are none on AVR by
+// default. Without a free one, extended frames are not received or sent.
+#ifndef TPUART_EXTENDED_TELEGRAM_POOL_SIZE
+#if defined(__AVR__)
+#define TPUART_EXTENDED_TELEGRAM_POOL_SIZE 0
+#else
+#define TPUART_EXTENDED_TELEGRAM_POOL_SIZE 2
+#endif
+#endif
+
+#if TPUART_EXTENDED_TELEGRAM_POOL_SIZE > 250
+#error "TPUART_EXTENDED_TELEGRAM_POOL_SIZE must be at most 250"
+#endif
+
+/*
+ * Fixed set of telegrams handed out as leases, allocated and released in
+ * constant time through a list of the free indexes. Two size classes:
+ * standard telegrams and extended ones, each with its own list. No heap:
+ * the telegrams live in the pool. A request that finds none free is counted.
+ */
+class KnxTelegramPool {
+    public:
+        KnxTelegramPool();
+
+        void clear();
+
+        // Cleared telegram, 0 if all are leased
+        KnxTelegram* allocate();
+        KnxExtendedTelegram* allocateExtended();
+        // Returns a leased telegram, ignores 0 and telegrams not leased from this pool
+        void release(KnxTelegram* telegram);
+        void release(KnxExtendedTelegram* telegram);
+
+        int getFreeCount();
+        int getExtendedFreeCount();
+        // Requests that found no free telegram, of both classes
+        unsigned long getExhaustedCount();
+
+    private:
+        KnxTelegram _telegrams[TPUART_TELEGRAM_POOL_SIZE];
+        byte _next[TPUART_TELEGRAM_POOL_SIZE];  // next free index, or leased
+        byte _free;     // first free index
+        byte _free_count;
+#if TPUART_EXTENDED_TELEGRAM_POOL_SIZE > 0
+        KnxExtendedTelegram _extended[TPUART_EXTENDED_TELEGRAM_POOL_SIZE];
+        byte _extended_next[TPUART_EXTENDED_TELEGRAM_POOL_SIZE];
+#endif
+        byte _extended_free;
+        byte _extended_free_count;
+        unsigned long _exhausted;
+
+        static void link(byte* next, int size, byte* free, byte* freeCount);
+        int take(byte* next, byte* free, byte* freeCount);
+        static void put(byte* next, int index, byte* free, byte* freeCount);
+};
+
+#endif
@@ -0,0 +1,327 @@
+#include "KnxTelegram.h"
+
+KnxTelegramView::KnxTelegramView(const byte* data, int length) {
+    _data = data;
+    _length = length;
+}
+
+/*
+ * True if the span holds at least the header and, according to the
+ * length in the header, the payload and checksum
+ */
+bool KnxTelegramView::isComplete() const {
+    return _length >= KNX_TELEGRAM_HEADER_SIZE && _length >= getHeaderSize() && _length >= getTotalLength();
+}
+
+// Frame type bit of the control byte cleared
+bool KnxTelegramView::isExtended() const {
+    return offset() != 0;
+}
+
+int KnxTelegramView::getHeaderSize() const {
+    return KNX_TELEGRAM_HEADER_SIZE + offset();
+}
+
+const byte* KnxTelegramView::getBuffer() const {
+    return _data;
+}
+
+int KnxTelegramView::getBufferByte(int index) const {
+    return _data[index];
+}
+
+bool KnxTelegramView::isRepeated() const {
+    // Parse Repeat Flag
+    if (_data[0] & B00100000) {
+        return false;
+    } else {
+        return true;
+    }
+}
+
+KnxPriorityType KnxTelegramView::getPriority() const {
+    // Priority
+    return (KnxPriorityType) ((_data[0] & B00001100) >> 2);
+}
+
+int KnxTelegramView::getSourceArea() const {
+    return (_data[1 + offset()] >> 4);
+}
+
+int KnxTelegramView::getSourceLine() const {
+    return (_data[1 + offset()] & B00001111);
+}
+
+int KnxTelegramView::getSourceMember() const {
+    return _data[2 + offset()];
+}
+
+bool KnxTelegramView::isTargetGroup() const {
+    // In the extra control byte of extended frames
+    return _data[isExtended() ? 1 : 5] & B10000000;
+}
+
+bool KnxTelegramView::isBroadcast() const {
+    return isTargetGroup() && _data[3 + offset()] == 0 && _data[4 + offset()] == 0;
+}
+
+/*
+ * Returns target address as 2bytes
+ * Depends on "isTargetGroup" how to interpret it: GA or PA
+ */
+void KnxTelegramView::getTarget(byte target[2]) const {
+    target[0] = _data[3 + offset()];
+    target[1] = _data[4 + offset()];
+}
+
+KnxIndividualAddress KnxTelegramView::getSourceAddress() const {
+    return KnxIndividualAddress::fromBytes(&_data[1 + offset()]);
+}
+
+KnxGroupAddress KnxTelegramView::getTargetGroupAddress() const {
+    return KnxGroupAddress::fromBytes(&_data[3 + offset()]);
+}
+
+KnxIndividualAddress KnxTelegramView::getTargetIndividualAddress() const {
+    return KnxIndividualAddress::fromBytes(&_data[3 + offset()]);
+}
+
+int KnxTelegramView::getTargetMainGroup() const {
+    return ((_data[3 + offset()] & B01111000) >> 3);
+}
+
+int KnxTelegramView::getTargetMiddleGroup() const {
+    return (_data[3 + offset()] & B00000111);
+}
+
+int KnxTelegramView::getTargetSubGroup() const {
+    return _data[4 + offset()];
+}
+
+int KnxTelegramView::getTargetArea() const {
+    return ((_data[3 + offset()] & B11110000) >> 4);
+}
+
+int KnxTelegramView::getTargetLine() const {
+    return (_data[3 + offset()] & B00001111);
+}
+
+int KnxTelegramView::getTargetMember() const {
+    return _data[4 + offset()];
+}
+
+int KnxTelegramView::getRoutingCounter() const {
+    return ((_data[isExtended() ? 1 : 5] & B01110000) >> 4);
+}
+
+int KnxTelegramView::getPayloadLength() const {
+    if (isExtended()) {
+        return _data[6] + 1;
+    }
+    int length = (_data[5] & B00001111) + 1;
+    return length;
+}
+
+KnxCommandType KnxTelegramView::getCommand() const {
+    int tpci = 6 + offset();
+    return (KnxCommandType) (((_data[tpci] & B00000011) << 2) | ((_data[tpci + 1] & B11000000) >> 6));
+}
+
+KnxExtendedCommandType KnxTelegramView::getExtendedCommand() const {
+    return (KnxExtendedCommandType) (_data[7 + offset()] & B00111111); // get only first six bits
+}
+
+KnxControlDataType KnxTelegramView::getControlData() const {
+    return (KnxControlDataType) (_data[6 + offset()] & B00000011);
+}
+
+KnxCommunicationType KnxTelegramView::getCommunicationType() const {
+    return (KnxCommunicationType) ((_data[6 + offset()] & B11000000) >> 6);
+}
+
+int KnxTelegramView::getSequenceNumber() const {
+    return (_data[6 + offset()] & B00111100) >> 2;
+}
+
+int KnxTelegramView::getFirstDataByte() const {
+    return (_data[7 + offset()] & B00111111);
+}
+
+// -1 if the span ends before the checksum
+int KnxTelegramView::getChecksum() const {
+    int checksumPos = getPayloadLength() + getHeaderSize();
+    if (checksumPos >= _length) {
+        return -1;
+    }
+    return _data[checksumPos];
+}
+
+bool KnxTelegramView::verifyChecksum() const {
+    // The checksum byte is past the span
+    if (!isComplete()) {
+        return false;
+    }
+    int calculatedChecksum = calculateChecksum();
+    return (getChecksum() == calculatedChecksum);
+}
+
+void KnxTelegramView::print(TPUART_SERIAL_CLASS* serial) const {
+#if defined(TPUART_DEBUG)
+    serial->print("Repeated: ");
+    serial->println(isRepeated());
+
+    serial->print("Priority: ");
+    serial->println(getPriority());
+
+    serial->print("Source: ");
+    serial->print(getSourceArea());
+    serial->print(".");
+    serial->print(getSourceLine());
+    serial->print(".");
+    serial->println(getSourceMember());
+
+    if (isTargetGroup()) {
+        serial->print("Target Group: ");
+        serial->print(getTargetMainGroup());
+        serial->print("/");
+        serial->print(getTargetMiddleGroup());
+        serial->print("/");
+        serial->println(getTargetSubGroup());
+    } else {
+        serial->print("Target Physical: ");
+        serial->print(getTargetArea());
+        serial->print(".");
+        serial->print(getTargetLine());
+        serial->print(".");
+        serial->println(getTargetMember());
+    }
+        
+    serial->print("Routing Counter: ");
+    serial->println(getRoutingCounter());
+
+    serial->print("Payload Length: ");
+    serial->println(getPayloadLength());
+
+    serial->print("Command: ");
+    serial->println(getCommand());
+
+    serial->print("First Data Byte: ");
+    serial->println(getFirstDataByte());
+
+    for (int i = 2; i < getPayloadLength(); i++) {
+        serial->print("Data Byte ");
+        serial->print(i);
+        serial->print(": ");
+        serial->println(_data[6 + offset() + i], BIN);
+    }
+
+
+    if (verifyChecksum()) {
+        serial->println("Checksum matches");
+    } else {
+        serial->println("Checksum mismatch");
+        serial->println(getChecksum(), BIN);
+        serial->println(calculateChecksum(), BIN);
+    }
+#endif
+}
+
+// -1 if the span ends before the checksum
+int KnxTelegramView::calculateChecksum() const {
+    int bcc = 0xFF;
+    int size = getPayloadLength() + getHeaderSize();
+    if (size >= _length) {
+        return -1;
+    }
+
+    for (int i = 0; i < size; i++) {
+        bcc ^= _data[i];
+    }
+
+    return bcc;
+}
+
+int KnxTelegramView::getTotalLength() const {
+    return getHeaderSize() + getPayloadLength() + 1;
+}
+
+/*
+ * DPT 1
+ * 1 bit
+ */
+bool KnxTelegramView::getBool() const {
+    if (getPayloadLength() != 2) {
+        // Wrong payload length
+        return 0;
+    }
+
+    return(getFirstDataByte() & B00000001);
+}
+
+/*
+ * DPT 4 / DPT 5
+ */
+int KnxTelegramView::get1ByteIntValue() const {
+    if (getPayloadLength() != 3) {
+        // Wrong payload length
+        return 0;
+    }
+
+    return getValue<Dpt<5> >();
+}
+
+/*
+ * DPT 9
+ * 2 byte float value
+ * 2 byte
+ */
+float KnxTelegramView::get2ByteFloatValue() const {
+    if (getPayloadLength() != 4) {
+        // Wrong payload length
+        return 0;
+    }
+
+    return getValue<Dpt<9> >();
+}
+
+/*
+ * DPT 8
+ * 2 byte signed value
+ * 2 byte
+ */
+int KnxTelegramView::get2ByteIntValue() const {
+    if (getPayloadLength() != 4) {
+        // Wrong payload length
+        return 0;
+    }
+
+    return getValue<Dpt<8> >();
+}
+
+/*
+ * DPT 14
+ * 4 byte float value
+ * 4 byte
+ */
+float KnxTelegramView::get4ByteFloatValue() const {
+    if (getPayloadLength() != 6) {
+        // Wrong payload length
+        return 0;
+    }
+    return getValue<Dpt<14> >();
+}
+
+/*
+ * DPT 16
+ * Character string
+ * 14 byte
+ */
+String KnxTelegramView::get14ByteValue(String value) const {
+    if (getPayloadLength() != 16) {
+        // Wrong payload length
+        return "";
+    }
+
+    // Terminated even if all 14 characters are used
+    return String(getValue<Dpt<16> >().text);
+}
@@ -6,10 +6,51 @@ KnxTpUart::KnxTpUart(TPUART_SERIAL_CLASS* sport, byte address[2]) {
     _individualAddress[0] = address[0];
     _individualAddress[1] = address[1];
     
-    _listen_group_address_count = 0;
-    _tg = new KnxTelegram();
-    _tg_ptp = new KnxTelegram();
+    // The pool is full, the first lease can't fail
+    _rx_telegram = _telegram_pool.allocate();
+    _rx_extended = 0;
+    _rx_extended_telegram = 0;
     _listen_to_broadcasts = false;
+    _hardware_address_mode = false;
+    _monitor = 0;
+
+    _rx_state = TPUART_RX_IDLE;
+    _rx_pos = 0;
+    _rx_length = 0;
+    _rx_checksum = 0;
+    _rx_last_byte_time = 0;
+    _rx_start_time = 0;
+    _rx_interested = false;
+    _rx_replay_pos = 0;
+    _rx_replay_length = 0;
+    _rx_replay_gap = -1;
+    _rx_resync = false;
+    _rx_ring = 0;
+    _rx_ring_data = 0;
+    _rx_ring_times = 0;
+    _rx_ring_pos = 0;
+    _rx_ring_count = 0;
+    _rx_ring_last_time = 0;
+    _rx_ring_empty_time = 0;
+    _rx_group_index = -1;
+    _rx_event_callback = 0;
+    _rx_event_callback_context = 0;
+
+    for (int i = 0; i < TPUART_TX_QUEUE_SIZE; i++) {
+        _tx_queue[i].telegram = 0;
+        _tx_queue[i].extended = 0;
+        _tx_queue[i].state = TPUART_TX_FREE;
+    }
+    _tx_next_handle = 0;
+    _tx_next_sequence = 0;
+    _tx_start_time = 0;
+    _tx_coalescing = TPUART_TX_COALESCE;
+    _tx_attempts = TPUART_TX_ATTEMPTS;
+    _tx_callback = 0;
+    _tx_callback_context = 0;
+}
+
+KnxTpUart::KnxTpUart(TPUART_SERIAL_CLASS* sport, KnxIndividualAddress address) : KnxTpUart(sport, address.getBytes()) {
 }
 
 void KnxTpUart::setListenToBroadcasts(bool listen) {
@@ -29,6 +70,59 @@ void KnxTpUart::uartStateRequest() {
 void KnxTpUart::setIndividualAddress(byte address[2]) {
     _individualAddress[0] = address[0];
     _individualAddress[1] = address[1];
+
+    if (_hardware_address_mode) {
+        sendUartAddress();
+    }
+}
+
+void KnxTpUart::setIndividualAddress(KnxIndividualAddress address) {
+    setIndividualAddress(address.getBytes());
+}
+
+void KnxTpUart::setHardwareAddressMode(bool on) {
+    _hardware_address_mode = on;
+
+    if (on) {
+        sendUartAddress();
+    }
+}
+
+void KnxTpUart::setMonitorMode(KnxMonitorBuffer* buffer) {
+    bool wasMonitoring = _monitor != 0;
+    _monitor = buffer;
+    _rx_state = TPUART_RX_IDLE;
+    _telegram_pool.release(_rx_extended);
+    _rx_extended = 0;
+
+    if (buffer != 0) {
+        _serialport->write((byte) TPUART_ACTIVATE_BUSMON);
+    } else if (wasMonitoring) {
+        // Only a reset ends the bus monitor mode of the TPUART
+        uartReset();
+    }
+}
+
+bool KnxTpUart::isMonitorMode() {
+    return _monitor != 0;
+}
+
+void KnxTpUart::setRxRing(KnxRxRing* ring) {
+    _rx_ring = ring;
+    _rx_ring_pos = 0;
+    _rx_ring_count = 0;
+    _rx_ring_empty_time = micros();
+}
+
+/*
+ * U_SetAddress: TPUART2 acknowledges telegrams to this address by itself
+ */
+void KnxTpUart::sendUartAddress() {
+    uint8_t sendbuf[3];
+    sendbuf[0] = TPUART2_SET_ADDRESS;
+    sendbuf[1] = _individualAddress[0];
+    sendbuf[2] = _individualAddress[1];
+    _serialport->write(sendbuf, 3);
 }
 
 void KnxTpUart::getIndividualAddress(byte address[2]) {
@@ -36,49 +130,483 @@ void KnxTpUart::getIndividualAddress(byte address[2]) {
     address[1] = _individualAddress[1];
 }
 
+KnxIndividualAddress KnxTpUart::getIndividualAddress() {
+    return KnxIndividualAddress::fromBytes(_individualAddress);
+}
+
+/*
+ * Consumes whatever bytes are available on the serial port without waiting
+ * for more. Returns as soon as an event is complete; bytes following it stay
+ * in the serial buffer for the next call. Returns INCOMPLETE_KNX_TELEGRAM if
+ * all available bytes were consumed in the middle of a telegram.
+ *
+ * Bytes of a rejected frame from its next control byte on are fed again
+ * first, so a telegram following a corrupted one is not lost.
+ */
 KnxTpUartSerialEventType KnxTpUart::serialEvent() {
-    while (_serialport->available() > 0) {
-        checkErrors();
-        
-        int incomingByte = _serialport->peek();
-        printByte(incomingByte);
-        
-        if (isKNXControlByte(incomingByte)) {
-            bool interested = readKNXTelegram();
-            if (interested) {
+    KnxTpUartSerialEventType eventType = readEvent();
+
+    if (_rx_ring != 0) {
+        // The bytes read from the ring are free for the producer again
+        _rx_ring->release(_rx_ring_pos);
+        _rx_ring_pos = 0;
+        _rx_ring_count = 0;
+    }
+    return eventType;
+}
+
+/*
+ * With a ring, bytes are taken from it in runs and frames end at silences
+ * between the times the bytes arrived, not when they are read
+ */
+KnxTpUartSerialEventType KnxTpUart::readEvent() {
+    for (;;) {
+        int incomingByte;
+        bool late = true;
+        bool replayed = false;
+        if (_rx_replay_pos < _rx_replay_length) {
+            if (_rx_replay_pos == _rx_replay_gap && _rx_state == TPUART_RX_TELEGRAM) {
+                return rejectFrame(KNX_MONITOR_TRUNCATED, true);
+            }
+            incomingByte = _rx_replay[_rx_replay_pos++];
+            replayed = true;
+        } else if (_rx_ring != 0) {
+            if (_rx_ring_pos == _rx_ring_count) {
+                _rx_ring->release(_rx_ring_pos);
+                _rx_ring_pos = 0;
+                _rx_ring_count = _rx_ring->peek(&_rx_ring_data, &_rx_ring_times);
+                if (_rx_ring_count == 0) {
+                    _rx_ring_empty_time = micros();
+                    break;
+                }
+            }
+
+            uint16_t time = _rx_ring_times[_rx_ring_pos];
+            if (_rx_state == TPUART_RX_TELEGRAM && (uint16_t) (time - _rx_ring_last_time) > TPUART_RX_GAP_US / 16) {
+                return rejectFrame(KNX_MONITOR_TRUNCATED, true);
+            }
+
+            incomingByte = _rx_ring_data[_rx_ring_pos++];
+            printByte(incomingByte);
+            _rx_ring_last_time = time;
+            // The byte arrived after the ring was last empty. Longer ago than
+            // a wrap of the times, its age can't be told from its time.
+            late = micros() - _rx_ring_empty_time > TPUART_RX_RING_TIME_WRAP_US
+                || (uint16_t) (KnxRxRing::time(micros()) - time) > TPUART_RX_ACK_WINDOW_US / 16;
+        } else if (_serialport->available() > 0) {
+            if (_rx_state == TPUART_RX_TELEGRAM && (millis() - _rx_last_byte_time) > SERIAL_READ_TIMEOUT_MS) {
+                // The byte after the gap is read with the next call
+                return rejectFrame(KNX_MONITOR_TRUNCATED, true);
+            }
+
+            checkErrors();
+
+            incomingByte = _serialport->read();
+            printByte(incomingByte);
+            _rx_last_byte_time = millis();
+            late = false;
+        } else {
+            break;
+        }
+
+        if (_rx_state == TPUART_RX_IDLE) {
+            _rx_resync = replayed;
+        }
+        KnxTpUartSerialEventType eventType = processRxByte(incomingByte, late);
+        if (eventType != INCOMPLETE_KNX_TELEGRAM) {
+            notifyRxEvent(eventType, incomingByte);
+            return eventType;
+        }
+    }
+
+    if (_rx_state == TPUART_RX_TELEGRAM) {
+        bool gap;
+        if (_rx_ring != 0) {
+            gap = (uint16_t) (KnxRxRing::time(micros()) - _rx_ring_last_time) > TPUART_RX_GAP_US / 16;
+        } else {
+            gap = millis() - _rx_last_byte_time > SERIAL_READ_TIMEOUT_MS;
+        }
+        if (gap) {
+            // No more bytes, the frame ended early
 #if defined(TPUART_DEBUG)
-                TPUART_DEBUG_PORT.println("Event KNX_TELEGRAM");
+            TPUART_DEBUG_PORT.println("Timeout while receiving message");
 #endif
-                return KNX_TELEGRAM;
-            } else {
+            return rejectFrame(KNX_MONITOR_TRUNCATED, true);
+        }
+        return INCOMPLETE_KNX_TELEGRAM;
+    }
 #if defined(TPUART_DEBUG)
-                TPUART_DEBUG_PORT.println("Event IRRELEVANT_KNX_TELEGRAM");
+    TPUART_DEBUG_PORT.println("Event UNKNOWN");
 #endif
-                return IRRELEVANT_KNX_TELEGRAM;
+    return UNKNOWN;
+}
+
+/*
+ * Receive state machine: feeds one byte received from the TPUART, or
+ * replayed from a rejected frame. late: too late to acknowledge a header
+ * completed by this byte. Never blocks, position within the telegram is
+ * kept across calls.
+ */
+KnxTpUartSerialEventType KnxTpUart::processRxByte(int incomingByte, bool late) {
+    if (_rx_state == TPUART_RX_IDLE) {
+        if (isKNXControlByte(incomingByte)) {
+            _rx_start_time = micros();
+            if (!(incomingByte & B10000000) && _monitor == 0) {
+                // Extended frame, received into the extended size class
+                _rx_extended = _telegram_pool.allocateExtended();
             }
+            setRxByte(0, incomingByte);
+            _rx_pos = 1;
+            _rx_length = _tg_rx.getView().getHeaderSize();
+            _rx_state = TPUART_RX_TELEGRAM;
+            return INCOMPLETE_KNX_TELEGRAM;
+        } else if (_monitor != 0 && (incomingByte == KNX_BUS_ACK || incomingByte == KNX_BUS_NACK || incomingByte == KNX_BUS_BUSY)) {
+            _rx_start_time = micros();
+            _tg_rx.setBufferByte(0, incomingByte);
+            pushMonitorFrame(KNX_MONITOR_ACK, 1);
+            return KNX_MONITOR_FRAME;
+        } else if (incomingByte == TPUART_DATA_CONFIRM_SUCCESS || incomingByte == TPUART_DATA_CONFIRM_FAILED) {
+#if defined(TPUART_DEBUG)
+            TPUART_DEBUG_PORT.println("Event TPUART_DATA_CONFIRM");
+#endif
+            finishTx(incomingByte == TPUART_DATA_CONFIRM_SUCCESS);
+            return TPUART_DATA_CONFIRM;
         } else if (incomingByte == TPUART_RESET_INDICATION_BYTE) {
-            serialRead();
 #if defined(TPUART_DEBUG)
             TPUART_DEBUG_PORT.println("Event TPUART_RESET_INDICATION");
 #endif
+            // A telegram handed to the TPUART before the reset is lost
+            finishTx(false);
+
+            // The reset cleared the address of the TPUART2
+            if (_hardware_address_mode) {
+                sendUartAddress();
+            }
+            // and ended the bus monitor mode
+            if (_monitor != 0) {
+                _serialport->write((byte) TPUART_ACTIVATE_BUSMON);
+            }
             return TPUART_RESET_INDICATION;
         } else {
-            serialRead();
 #if defined(TPUART_DEBUG)
             TPUART_DEBUG_PORT.println("Event UNKNOWN");
 #endif
             return UNKNOWN;
         }
     }
+
+    setRxByte(_rx_pos, incomingByte);
+    _rx_pos++;
+
+    if (_rx_pos == _tg_rx.getView().getHeaderSize()) {
+        // Header complete: target address and address type are known, so
+        // acknowledge right away to meet the deadline of the TPUART
+        _rx_interested = isAddressed(&_tg_rx);
+        // Length 0xFF is the escape code of frames longer than an extended
+        // telegram holds
+        bool escape = _tg_rx.getView().isExtended() && _tg_rx.getPayloadLength() > MAX_KNX_EXTENDED_PAYLOAD_LENGTH;
+        if (_monitor != 0) {
+            // Only listening
+        } else if (late) {
+            // Replayed, or waited in the ring too long
+        } else if (_hardware_address_mode && !_tg_rx.isTargetGroup()) {
+            // Acknowledged by the TPUART2 itself
+        } else if (_rx_interested && escape) {
+            sendAckInformation(true, false, true);
+        } else if (_rx_interested && _tg_rx.getView().isExtended() && _rx_extended == 0) {
+            // No room for it, the sender repeats it
+            sendAckInformation(true, true, false);
+        } else if (_rx_interested) {
+            sendAck();
+        } else {
+            sendNotAddressed();
+        }
+
+        if (escape) {
+            // Skipped to its end, then rejected
+            _telegram_pool.release(_rx_extended);
+            _rx_extended = 0;
+        }
+
+        // Now we know the length of payload + checksum
+        _rx_length = _tg_rx.getTotalLength();
 #if defined(TPUART_DEBUG)
-    TPUART_DEBUG_PORT.println("Event UNKNOWN");
+        TPUART_DEBUG_PORT.print("Payload Length: ");
+        TPUART_DEBUG_PORT.println(_tg_rx.getPayloadLength());
 #endif
-    return UNKNOWN;
+    }
+
+    if (_rx_pos < _rx_length) {
+        return INCOMPLETE_KNX_TELEGRAM;
+    }
+
+    // Checksum received, telegram is complete
+    if (_tg_rx.getView().isExtended()) {
+        return completeExtendedFrame();
+    }
+    if (!_tg_rx.verifyChecksum()) {
+        // Acknowledged already if it was for us, the sender won't repeat it
+#if defined(TPUART_DEBUG)
+        TPUART_DEBUG_PORT.println("Checksum error");
+#endif
+        return rejectFrame(KNX_MONITOR_CHECKSUM_ERROR, false);
+    }
+    _rx_state = TPUART_RX_IDLE;
+
+    if (_monitor != 0) {
+        pushMonitorFrame(0, _rx_length);
+        return KNX_MONITOR_FRAME;
+    }
+
+    // Our own frames are counted when they are confirmed
+    if (_tg_rx.getBufferByte(1) != _individualAddress[0] || _tg_rx.getBufferByte(2) != _individualAddress[1]) {
+        _bus_load.addFrame(_rx_length, _rx_start_time);
+    }
+
+    *_rx_telegram = _tg_rx;
+
+    bool interested = processReceivedTelegram(_rx_interested);
+
+    bool answered = false;
+    if (interested && _rx_group_index >= 0) {
+        answered = processGroupObject(_rx_group_index, _rx_telegram);
+        if (!answered) {
+            _group_handlers.dispatch(_rx_group_index, _rx_telegram->getCommand(), _rx_telegram);
+        }
+    }
+
+    // Sending was held back while the telegram was received
+    startTx();
+
+    if (answered) {
+#if defined(TPUART_DEBUG)
+        TPUART_DEBUG_PORT.println("Event KNX_GROUP_READ_ANSWERED");
+#endif
+        return KNX_GROUP_READ_ANSWERED;
+    } else if (interested) {
+#if defined(TPUART_DEBUG)
+        TPUART_DEBUG_PORT.println("Event KNX_TELEGRAM");
+#endif
+        return KNX_TELEGRAM;
+    } else {
+#if defined(TPUART_DEBUG)
+        TPUART_DEBUG_PORT.println("Event IRRELEVANT_KNX_TELEGRAM");
+#endif
+        return IRRELEVANT_KNX_TELEGRAM;
+    }
+}
+
+/*
+ * An extended frame is complete: for us it replaces the last one received,
+ * others go back to the pool. Without an extended telegram from the pool only
+ * its header was kept, it is skipped. One with the length escape is an error.
+ */
+KnxTpUartSerialEventType KnxTpUart::completeExtendedFrame() {
+    if (_monitor == 0 && _tg_rx.getPayloadLength() > MAX_KNX_EXTENDED_PAYLOAD_LENGTH) {
+        return rejectFrame(KNX_MONITOR_CHECKSUM_ERROR, false);
+    }
+    // Over all bytes, also those of a frame kept only in part
+    if (_rx_checksum != 0xFF) {
+#if defined(TPUART_DEBUG)
+        TPUART_DEBUG_PORT.println("Checksum error");
+#endif
+        return rejectFrame(KNX_MONITOR_CHECKSUM_ERROR, false);
+    }
+    _rx_state = TPUART_RX_IDLE;
+
+    if (_monitor != 0) {
+        // As much as a monitored frame holds
+        pushMonitorFrame(0, _rx_length);
+        return KNX_MONITOR_FRAME;
+    }
+
+    if (_tg_rx.getView().getSourceAddress() != getIndividualAddress()) {
+        _bus_load.addFrame(_rx_length, _rx_start_time);
+    }
+
+    startTx();
+
+    if (_rx_extended == 0 || !_rx_interested) {
+#if defined(TPUART_DEBUG)
+        TPUART_DEBUG_PORT.println("Event IRRELEVANT_KNX_TELEGRAM");
+#endif
+        // Reported here, the telegram goes back to the pool right away
+        if (_rx_event_callback != 0 && _rx_extended != 0) {
+            _rx_event_callback(IRRELEVANT_KNX_TELEGRAM, _rx_extended->getBuffer(), _rx_extended->getTotalLength(), _rx_start_time, _rx_event_callback_context);
+        }
+        _telegram_pool.release(_rx_extended);
+        _rx_extended = 0;
+        return IRRELEVANT_KNX_TELEGRAM;
+    }
+
+    // Unless the application took the last one
+    _telegram_pool.release(_rx_extended_telegram);
+    _rx_extended_telegram = _rx_extended;
+    _rx_extended = 0;
+
+#if defined(TPUART_DEBUG)
+    TPUART_DEBUG_PORT.println("Event KNX_EXTENDED_TELEGRAM");
+#endif
+    return KNX_EXTENDED_TELEGRAM;
+}
+
+/*
+ * Bytes of the frame being received: in _tg_rx as far as it holds them, and
+ * all of them in the extended telegram of an extended frame. All of them go
+ * into the checksum.
+ */
+void KnxTpUart::setRxByte(int index, int content) {
+    _rx_checksum = index == 0 ? content : _rx_checksum ^ content;
+    if (index < MAX_KNX_TELEGRAM_SIZE) {
+        _tg_rx.setBufferByte(index, content);
+    }
+    if (_rx_extended != 0) {
+        _rx_extended->setBufferByte(index, content);
+    }
 }
 
+int KnxTpUart::getRxByte(int index) {
+    if (_rx_extended != 0) {
+        return _rx_extended->getBufferByte(index);
+    }
+    return index < MAX_KNX_TELEGRAM_SIZE ? _tg_rx.getBufferByte(index) : 0;
+}
+
+/*
+ * Ends the frame in _tg_rx as error (or in the monitor buffer with
+ * monitorFlags) and feeds its bytes from the next control byte on again,
+ * before the bytes not yet replayed. With gap, the frame was ended by a gap
+ * after its last byte, which the replayed bytes can't continue either.
+ */
+KnxTpUartSerialEventType KnxTpUart::rejectFrame(byte monitorFlags, bool gap) {
+    int length = _rx_pos;
+    _rx_state = TPUART_RX_IDLE;
+
+    KnxTpUartSerialEventType eventType;
+    if (_monitor != 0) {
+        pushMonitorFrame(monitorFlags, length);
+        eventType = KNX_MONITOR_FRAME;
+    } else if (_rx_resync) {
+        // Started in the bytes of a frame already reported, a failed resync.
+        // Data bytes look like extended control bytes more often than not.
+        eventType = INCOMPLETE_KNX_TELEGRAM;
+    } else {
+#if defined(TPUART_DEBUG)
+        TPUART_DEBUG_PORT.println("Event KNX_TELEGRAM_ERROR");
+#endif
+        eventType = KNX_TELEGRAM_ERROR;
+        if (_rx_event_callback != 0) {
+            if (_rx_extended != 0) {
+                _rx_event_callback(eventType, _rx_extended->getBuffer(), length, _rx_start_time, _rx_event_callback_context);
+            } else {
+                int stored = length < MAX_KNX_TELEGRAM_SIZE ? length : MAX_KNX_TELEGRAM_SIZE;
+                _rx_event_callback(eventType, _tg_rx.getView().getBuffer(), stored, _rx_start_time, _rx_event_callback_context);
+            }
+        }
+    }
+
+    int first = 1;
+    while (first < length && !isKNXControlByte(getRxByte(first))) {
+        first++;
+    }
+
+    // Bytes not replayed yet stay behind the rescanned ones, a pending gap with them
+    byte rest[MAX_KNX_TELEGRAM_SIZE];
+    int restLength = _rx_replay_length - _rx_replay_pos;
+    for (int i = 0; i < restLength; i++) {
+        rest[i] = _rx_replay[_rx_replay_pos + i];
+    }
+    // A gap after the last replayed byte was left to the received bytes
+    bool restHasGap = _rx_replay_gap >= _rx_replay_pos && _rx_replay_gap < _rx_replay_length;
+    int restGap = restHasGap ? _rx_replay_gap - _rx_replay_pos : -1;
+
+    // Of a long extended frame as many bytes as fit
+    _rx_replay_length = 0;
+    for (int i = first; i < length && _rx_replay_length < MAX_KNX_TELEGRAM_SIZE - restLength; i++) {
+        _rx_replay[_rx_replay_length++] = getRxByte(i);
+    }
+    _telegram_pool.release(_rx_extended);
+    _rx_extended = 0;
+    if (gap) {
+        _rx_replay_gap = _rx_replay_length;
+    } else if (restGap >= 0) {
+        _rx_replay_gap = _rx_replay_length + restGap;
+    } else {
+        _rx_replay_gap = -1;
+    }
+    for (int i = 0; i < restLength; i++) {
+        _rx_replay[_rx_replay_length++] = rest[i];
+    }
+    _rx_replay_pos = 0;
+
+    return eventType;
+}
+
+void KnxTpUart::setRxEventCallback(KnxRxEventCallback callback, void* context) {
+    _rx_event_callback = callback;
+    _rx_event_callback_context = context;
+}
+
+/*
+ * Passes a completed event with its bytes to the observer
+ */
+void KnxTpUart::notifyRxEvent(KnxTpUartSerialEventType eventType, int incomingByte) {
+    if (_rx_event_callback == 0) {
+        return;
+    }
+
+    if (eventType == KNX_MONITOR_FRAME || eventType == KNX_TELEGRAM_ERROR
+            || (eventType == IRRELEVANT_KNX_TELEGRAM && _tg_rx.getView().isExtended())) {
+        // Reported by pushMonitorFrame() / rejectFrame() / completeExtendedFrame()
+    } else if (eventType == KNX_EXTENDED_TELEGRAM) {
+        _rx_event_callback(eventType, _rx_extended_telegram->getBuffer(), _rx_extended_telegram->getTotalLength(), _rx_start_time, _rx_event_callback_context);
+    } else if (eventType == KNX_TELEGRAM || eventType == IRRELEVANT_KNX_TELEGRAM) {
+        byte frame[MAX_KNX_TELEGRAM_SIZE];
+        int length = _rx_telegram->getTotalLength();
+        for (int i = 0; i < length; i++) {
+            frame[i] = _rx_telegram->getBufferByte(i);
+        }
+        _rx_event_callback(eventType, frame, length, _rx_start_time, _rx_event_callback_context);
+    } else {
+        byte service = incomingByte;
+        _rx_event_callback(eventType, &service, 1, micros(), _rx_event_callback_context);
+    }
+}
+
+/*
+ * Stores the bytes received in _tg_rx in the monitor buffer
+ */
+void KnxTpUart::pushMonitorFrame(byte flags, int length) {
+    KnxMonitorFrame* frame = _monitor->beginWrite();
+    if (frame == 0) {
+#if defined(TPUART_DEBUG)
+        TPUART_DEBUG_PORT.println("Monitor buffer full, frame lost");
+#endif
+        return;
+    }
+
+    if (length > MAX_KNX_TELEGRAM_SIZE) {
+        // Extended frame
+        length = MAX_KNX_TELEGRAM_SIZE;
+        flags |= KNX_MONITOR_PARTIAL;
+    }
+
+    frame->time = _rx_start_time;
+    frame->flags = flags;
+    frame->length = length;
+    for (int i = 0; i < length; i++) {
+        frame->data[i] = getRxByte(i);
+    }
+    _monitor->commitWrite();
+
+    if (_rx_event_callback != 0) {
+        _rx_event_callback(KNX_MONITOR_FRAME, frame->data, length, frame->time, _rx_event_callback_context);
+    }
+}
 
 bool KnxTpUart::isKNXControlByte(int b) {
-    return ( (b | B00101100) == B10111100 ); // Ignore repeat flag and priority flag
+    // Ignore repeat flag and priority flag, standard or extended frame
+    return ( (b | B00101100) == B10111100 || (b | B00101100) == B00111100 );
 }
 
 void KnxTpUart::checkErrors() {
@@ -127,44 +655,27 @@ void KnxTpUart::printByte(int incomingByte) {
 #endif
 }
 
-bool KnxTpUart::readKNXTelegram() {
-    // Receive header
-    for (int i = 0; i < 6; i++) {
-        _tg->setBufferByte(i, serialRead());
-    }
-
-#if defined(TPUART_DEBUG)
-    TPUART_DEBUG_PORT.print("Payload Length: ");
-    TPUART_DEBUG_PORT.println(_tg->getPayloadLength());
-#endif
-    int bufpos = 6;
-    for (int i = 0; i < _tg->getPayloadLength(); i++) {
-        _tg->setBufferByte(bufpos, serialRead());
-        bufpos++; 
-    }
-
-    // Checksum
-    _tg->setBufferByte(bufpos, serialRead());
-
-#if defined(TPUART_DEBUG)
-    // Print the received telegram
-    _tg->print(&TPUART_DEBUG_PORT);
-#endif
-
+/*
+ * Decides if we are addressed by a telegram. Needs the header only,
+ * so it can be called as soon as the header has been received.
+ */
+bool KnxTpUart::isAddressed(KnxTelegram* telegram) {
     // get targetaddress if telegram
     byte target[2];
-    _tg->getTarget(target);
+    telegram->getTarget(target);
 
     // Verify if we are interested in this message:
-    // GroupAddress
-    bool interestedGA = _tg->isTargetGroup() && isListeningToGroupAddress(target);
+    // GroupAddress, the index of a single address also selects the handler
+    _rx_group_index = telegram->isTargetGroup() ? _listen_group_addresses.indexOf(target) : -1;
+    bool interestedGA = telegram->isTargetGroup() && (_rx_group_index >= 0 || isListeningToGroupAddress(target));
     
     // Physical address
-    bool interestedPA = ((!_tg->isTargetGroup()) && target[0] == _individualAddress[0] && target[1] == _individualAddress[1]);
+    bool interestedPA = ((!telegram->isTargetGroup()) && target[0] == _individualAddress[0] && target[1] == _individualAddress[1]);
     
     // Broadcast (Programming Mode)
-    bool interestedBC = (_listen_to_broadcasts && _tg->isBroadcast());
+    bool interestedBC = (_listen_to_broadcasts && telegram->isBroadcast());
 
+#if defined(TPUART_DEBUG)
     TPUART_DEBUG_PORT.print("Interested GA: ");
     TPUART_DEBUG_PORT.println(interestedGA);
     TPUART_DEBUG_PORT.print("Interested PA: ");
@@ -177,27 +688,35 @@ bool KnxTpUart::readKNXTelegram() {
     TPUART_DEBUG_PORT.print(" [1]=");
     TPUART_DEBUG_PORT.print(target[1]);
     TPUART_DEBUG_PORT.println();
+#endif
 
-    bool interested = interestedGA || interestedPA ||interestedBC;
+    return interestedGA || interestedPA || interestedBC;
+}
 
-    if (interested) {
-        sendAck();
-    } else {
-        sendNotAddressed();
-    }
+bool KnxTpUart::processReceivedTelegram(bool interested) {
+#if defined(TPUART_DEBUG)
+    // Print the received telegram
+    _rx_telegram->print(&TPUART_DEBUG_PORT);
+#endif
 
-    if (_tg->getCommunicationType() == KNX_COMM_UCD) {
+    if (_rx_telegram->getCommunicationType() == KNX_COMM_UCD) {
 #if defined(TPUART_DEBUG)
       TPUART_DEBUG_PORT.println("UCD Telegram received");
 #endif
-    } else if (_tg->getCommunicationType() == KNX_COMM_NCD) {
+    } else if (_rx_telegram->getCommunicationType() == KNX_COMM_NCD) {
 #if defined(TPUART_DEBUG)
         TPUART_DEBUG_PORT.print("NCD Telegram ");
-        TPUART_DEBUG_PORT.print(_tg->getSequenceNumber());
+        TPUART_DEBUG_PORT.print(_rx_telegram->getSequenceNumber());
         TPUART_DEBUG_PORT.println(" received");
 #endif
-        if (interested) {
-            sendNCDPosConfirm(_tg->getSequenceNumber(), PA_INTEGER(_tg->getSourceArea(), _tg->getSourceLine(), _tg->getSourceMember()));
+    }
+
+    if (interested && !_rx_telegram->isTargetGroup() && _rx_telegram->getTargetIndividualAddress() == getIndividualAddress()) {
+        KnxTransportResult result = _connection.receive(_rx_telegram);
+        // T_ACK right away, or as soon as there is room
+        sendTransport();
+        if (result == KNX_TRANSPORT_HANDLED) {
+            return false;
         }
     }
     
@@ -205,8 +724,117 @@ bool KnxTpUart::readKNXTelegram() {
     return interested;
 }
 
+/*
+ * Updates the group object of a received write or answer, answers a read
+ * from it. Returns true if the read was answered and is not reported.
+ */
+bool KnxTpUart::processGroupObject(int filterIndex, KnxTelegram* telegram) {
+    KnxGroupObject* object = _group_objects.find(filterIndex);
+    if (object == 0) {
+        return false;
+    }
+
+    KnxCommandType command = telegram->getCommand();
+    if (command == KNX_COMMAND_WRITE || command == KNX_COMMAND_ANSWER) {
+        _group_objects.update(object, telegram);
+        return false;
+    }
+    if (command != KNX_COMMAND_READ || !(object->flags & KNX_GROUP_OBJECT_VALID)) {
+        return false;
+    }
+
+    // In its own telegram, the received one stays as it is. Without one the
+    // application gets the read.
+    KnxTelegram* answer = _telegram_pool.allocate();
+    if (answer == 0) {
+        return false;
+    }
+    answer->setSourceAddress(_individualAddress);
+    answer->setTargetGroupAddress(telegram->getTargetGroupAddress());
+    _group_objects.copyValue(object, answer);
+    answer->setCommand(KNX_COMMAND_ANSWER);
+    answer->createChecksum();
+    sendLeasedTelegram(answer, _tx_callback, _tx_callback_context);
+
+    return !(object->flags & KNX_GROUP_OBJECT_NOTIFY_READ);
+}
+
+/*
+ * Takes the value of a group write or answer we send into its group object
+ */
+void KnxTpUart::updateGroupObject(KnxTelegram* telegram) {
+    KnxCommandType command = telegram->getCommand();
+    if (!telegram->isTargetGroup() || (command != KNX_COMMAND_WRITE && command != KNX_COMMAND_ANSWER)) {
+        return;
+    }
+
+    byte target[2];
+    telegram->getTarget(target);
+    KnxGroupObject* object = _group_objects.find(_listen_group_addresses.indexOf(target));
+    if (object != 0) {
+        _group_objects.update(object, telegram);
+    }
+}
+
 KnxTelegram* KnxTpUart::getReceivedTelegram() {
-    return _tg;
+    return _rx_telegram;
+}
+
+/*
+ * Hands the received telegram to the application and receives into a new
+ * one from the pool
+ */
+KnxTelegram* KnxTpUart::takeReceivedTelegram() {
+    KnxTelegram* next = _telegram_pool.allocate();
+    if (next == 0) {
+#if defined(TPUART_DEBUG)
+        TPUART_DEBUG_PORT.println("Telegram pool exhausted, cannot take telegram");
+#endif
+        return 0;
+    }
+
+    KnxTelegram* taken = _rx_telegram;
+    *next = *taken;
+    _rx_telegram = next;
+    return taken;
+}
+
+void KnxTpUart::releaseTelegram(KnxTelegram* telegram) {
+    if (telegram != _rx_telegram) {
+        _telegram_pool.release(telegram);
+    }
+}
+
+KnxExtendedTelegram* KnxTpUart::getReceivedExtendedTelegram() {
+    return _rx_extended_telegram;
+}
+
+KnxExtendedTelegram* KnxTpUart::takeReceivedExtendedTelegram() {
+    KnxExtendedTelegram* taken = _rx_extended_telegram;
+    _rx_extended_telegram = 0;
+    return taken;
+}
+
+KnxExtendedTelegram* KnxTpUart::allocateExtendedTelegram() {
+    return _telegram_pool.allocateExtended();
+}
+
+void KnxTpUart::releaseTelegram(KnxExtendedTelegram* telegram) {
+    if (telegram != _rx_extended_telegram && telegram != _rx_extended) {
+        _telegram_pool.release(telegram);
+    }
+}
+
+int KnxTpUart::getFreeExtendedTelegramCount() {
+    return _telegram_pool.getExtendedFreeCount();
+}
+
+int KnxTpUart::getFreeTelegramCount() {
+    return _telegram_pool.getFreeCount();
+}
+
+unsigned long KnxTpUart::getTelegramPoolExhaustedCount() {
+    return _telegram_pool.getExhaustedCount();
 }
 
 bool KnxTpUart::groupWriteBool(byte groupAddress[2], bool value) {
@@ -215,43 +843,58 @@ bool KnxTpUart::groupWriteBool(byte groupAddress[2], bool value) {
         valueAsInt = B00000001;
     }
     
-    createKNXMessageFrame(2, KNX_COMMAND_WRITE, groupAddress, valueAsInt);
-    return sendMessage();
+    KnxTelegram* telegram = createKNXMessageFrame(2, KNX_COMMAND_WRITE, groupAddress, valueAsInt);
+    return sendMessage(telegram);
 }
 
 bool KnxTpUart::groupWrite2ByteFloat(byte groupAddress[2], float value) {
-    createKNXMessageFrame(2, KNX_COMMAND_WRITE, groupAddress, 0);
-    _tg->set2ByteFloatValue(value);
-    _tg->createChecksum();
-    return sendMessage();
+    KnxTelegram* telegram = createKNXMessageFrame(2, KNX_COMMAND_WRITE, groupAddress, 0);
+    if (telegram == 0) {
+        return false;
+    }
+    telegram->set2ByteFloatValue(value);
+    telegram->createChecksum();
+    return sendMessage(telegram);
 }
 
 bool KnxTpUart::groupWrite2ByteInt(byte groupAddress[2], int value) {
-    createKNXMessageFrame(2, KNX_COMMAND_WRITE, groupAddress, 0);
-    _tg->set2ByteFloatValue(value);
-    _tg->createChecksum();
-    return sendMessage();
+    KnxTelegram* telegram = createKNXMessageFrame(2, KNX_COMMAND_WRITE, groupAddress, 0);
+    if (telegram == 0) {
+        return false;
+    }
+    telegram->set2ByteIntValue(value);
+    telegram->createChecksum();
+    return sendMessage(telegram);
 }
 
 bool KnxTpUart::groupWrite1ByteInt(byte groupAddress[2], int value) {
-    createKNXMessageFrame(2, KNX_COMMAND_WRITE, groupAddress, 0);
-    _tg->set1ByteIntValue(value);
-    _tg->createChecksum();
-    return sendMessage();
+    KnxTelegram* telegram = createKNXMessageFrame(2, KNX_COMMAND_WRITE, groupAddress, 0);
+    if (telegram == 0) {
+        return false;
+    }
+    telegram->set1ByteIntValue(value);
+    telegram->createChecksum();
+    return sendMessage(telegram);
 }
 
 bool KnxTpUart::groupWrite4ByteFloat(byte groupAddress[2], float value) {
-    createKNXMessageFrame(2, KNX_COMMAND_WRITE, groupAddress, 0);
-    _tg->set4ByteFloatValue(value);
-    _tg->createChecksum();
-    return sendMessage();
+    KnxTelegram* telegram = createKNXMessageFrame(2, KNX_COMMAND_WRITE, groupAddress, 0);
+    if (telegram == 0) {
+        return false;
+    }
+    telegram->set4ByteFloatValue(value);
+    telegram->createChecksum();
+    return sendMessage(telegram);
 }
 
 bool KnxTpUart::groupWrite14ByteText(byte groupAddress[2], String value) {
-    createKNXMessageFrame(2, KNX_COMMAND_WRITE, groupAddress, 0);
-    _tg->set14ByteValue(value);
-    _tg->createChecksum();
-    return sendMessage();
+    KnxTelegram* telegram = createKNXMessageFrame(2, KNX_COMMAND_WRITE, groupAddress, 0);
+    if (telegram == 0) {
+        return false;
+    }
+    telegram->set14ByteValue(value);
+    telegram->createChecksum();
+    return sendMessage(telegram);
 }
 
 bool KnxTpUart::groupAnswerBool(byte groupAddress[2], bool value) {
@@ -260,258 +903,752 @@ bool KnxTpUart::groupAnswerBool(byte groupAddress[2], bool value) {
         valueAsInt = B00000001;
     }
     
-    createKNXMessageFrame(2, KNX_COMMAND_ANSWER, groupAddress, valueAsInt);
-    return sendMessage();
+    KnxTelegram* telegram = createKNXMessageFrame(2, KNX_COMMAND_ANSWER, groupAddress, valueAsInt);
+    return sendMessage(telegram);
 }
 
 bool KnxTpUart::groupAnswer1ByteInt(byte groupAddress[2], int value) {
-    createKNXMessageFrame(2, KNX_COMMAND_ANSWER, groupAddress, 0);
-    _tg->set1ByteIntValue(value);
-    _tg->createChecksum();
-    return sendMessage();
+    KnxTelegram* telegram = createKNXMessageFrame(2, KNX_COMMAND_ANSWER, groupAddress, 0);
+    if (telegram == 0) {
+        return false;
+    }
+    telegram->set1ByteIntValue(value);
+    telegram->createChecksum();
+    return sendMessage(telegram);
 }
 
 bool KnxTpUart::groupAnswer2ByteFloat(byte groupAddress[2], float value) {
-    createKNXMessageFrame(2, KNX_COMMAND_ANSWER, groupAddress, 0);
-    _tg->set2ByteFloatValue(value);
-    _tg->createChecksum();
-    return sendMessage();
+    KnxTelegram* telegram = createKNXMessageFrame(2, KNX_COMMAND_ANSWER, groupAddress, 0);
+    if (telegram == 0) {
+        return false;
+    }
+    telegram->set2ByteFloatValue(value);
+    telegram->createChecksum();
+    return sendMessage(telegram);
 }
 
 bool KnxTpUart::groupAnswer2ByteInt(byte groupAddress[2], int value) {
-    createKNXMessageFrame(2, KNX_COMMAND_ANSWER, groupAddress, 0);
-    _tg->set2ByteFloatValue(value);
-    _tg->createChecksum();
-    return sendMessage();
+    KnxTelegram* telegram = createKNXMessageFrame(2, KNX_COMMAND_ANSWER, groupAddress, 0);
+    if (telegram == 0) {
+        return false;
+    }
+    telegram->set2ByteIntValue(value);
+    telegram->createChecksum();
+    return sendMessage(telegram);
 }
 
 bool KnxTpUart::groupAnswer4ByteFloat(byte groupAddress[2], float value) {
-    createKNXMessageFrame(2, KNX_COMMAND_ANSWER, groupAddress, 0);
-    _tg->set4ByteFloatValue(value);
-    _tg->createChecksum();
-    return sendMessage();
+    KnxTelegram* telegram = createKNXMessageFrame(2, KNX_COMMAND_ANSWER, groupAddress, 0);
+    if (telegram == 0) {
+        return false;
+    }
+    telegram->set4ByteFloatValue(value);
+    telegram->createChecksum();
+    return sendMessage(telegram);
 }
 
 bool KnxTpUart::groupAnswer14ByteText(byte groupAddress[2], String value) {
-    createKNXMessageFrame(2, KNX_COMMAND_ANSWER, groupAddress, 0);
-    _tg->set14ByteValue(value);
-    _tg->createChecksum();
-    return sendMessage();
+    KnxTelegram* telegram = createKNXMessageFrame(2, KNX_COMMAND_ANSWER, groupAddress, 0);
+    if (telegram == 0) {
+        return false;
+    }
+    telegram->set14ByteValue(value);
+    telegram->createChecksum();
+    return sendMessage(telegram);
 }
 
 bool KnxTpUart::groupWriteTime(byte groupAddress[2], int day, int hours, int minutes, int seconds) {
-    createKNXMessageFrame(2, KNX_COMMAND_WRITE, groupAddress, 0);
-    _tg->setKNXTime(day, hours, minutes, seconds);
-    _tg->createChecksum();
-    return sendMessage();
+    KnxTelegram* telegram = createKNXMessageFrame(2, KNX_COMMAND_WRITE, groupAddress, 0);
+    if (telegram == 0) {
+        return false;
+    }
+    telegram->setKNXTime(day, hours, minutes, seconds);
+    telegram->createChecksum();
+    return sendMessage(telegram);
+}
+
+void KnxTpUart::prepareGroupTelegram(KnxPreparedTelegram* prepared, KnxCommandType command, byte groupAddress[2], int payloadLength) {
+    prepared->prepare(_individualAddress, groupAddress, command, payloadLength);
+}
+
+bool KnxTpUart::sendPrepared(KnxPreparedTelegram* prepared) {
+    return sendTelegram(prepared->getTelegram(), _tx_callback, _tx_callback_context) >= 0;
+}
+
+bool KnxTpUart::groupWriteBool(KnxGroupAddress groupAddress, bool value) {
+    return groupWriteBool(groupAddress.getBytes(), value);
+}
+
+bool KnxTpUart::groupWrite2ByteFloat(KnxGroupAddress groupAddress, float value) {
+    return groupWrite2ByteFloat(groupAddress.getBytes(), value);
+}
+
+bool KnxTpUart::groupWrite1ByteInt(KnxGroupAddress groupAddress, int value) {
+    return groupWrite1ByteInt(groupAddress.getBytes(), value);
+}
+
+bool KnxTpUart::groupWrite2ByteInt(KnxGroupAddress groupAddress, int value) {
+    return groupWrite2ByteInt(groupAddress.getBytes(), value);
+}
+
+bool KnxTpUart::groupWrite4ByteFloat(KnxGroupAddress groupAddress, float value) {
+    return groupWrite4ByteFloat(groupAddress.getBytes(), value);
+}
+
+bool KnxTpUart::groupWrite14ByteText(KnxGroupAddress groupAddress, String value) {
+    return groupWrite14ByteText(groupAddress.getBytes(), value);
+}
+
+bool KnxTpUart::groupAnswerBool(KnxGroupAddress groupAddress, bool value) {
+    return groupAnswerBool(groupAddress.getBytes(), value);
+}
+
+bool KnxTpUart::groupAnswer2ByteFloat(KnxGroupAddress groupAddress, float value) {
+    return groupAnswer2ByteFloat(groupAddress.getBytes(), value);
+}
+
+bool KnxTpUart::groupAnswer1ByteInt(KnxGroupAddress groupAddress, int value) {
+    return groupAnswer1ByteInt(groupAddress.getBytes(), value);
+}
+
+bool KnxTpUart::groupAnswer2ByteInt(KnxGroupAddress groupAddress, int value) {
+    return groupAnswer2ByteInt(groupAddress.getBytes(), value);
+}
+
+bool KnxTpUart::groupAnswer4ByteFloat(KnxGroupAddress groupAddress, float value) {
+    return groupAnswer4ByteFloat(groupAddress.getBytes(), value);
+}
+
+bool KnxTpUart::groupAnswer14ByteText(KnxGroupAddress groupAddress, String value) {
+    return groupAnswer14ByteText(groupAddress.getBytes(), value);
+}
+
+bool KnxTpUart::groupWriteTime(KnxGroupAddress groupAddress, int day, int hours, int minutes, int seconds) {
+    return groupWriteTime(groupAddress.getBytes(), day, hours, minutes, seconds);
+}
+
+void KnxTpUart::prepareGroupTelegram(KnxPreparedTelegram* prepared, KnxCommandType command, KnxGroupAddress groupAddress, int payloadLength) {
+    prepareGroupTelegram(prepared, command, groupAddress.getBytes(), payloadLength);
 }
 
 bool KnxTpUart::individualAnswerAddress() {
-    createKNXMessageFrame(2, KNX_COMMAND_INDIVIDUAL_ADDR_RESPONSE, PA_INTEGER(0,0,0), 0);
-    _tg->createChecksum();
-    return sendMessage();    
+    KnxTelegram* telegram = createKNXMessageFrame(2, KNX_COMMAND_INDIVIDUAL_ADDR_RESPONSE, KnxGroupAddress(0, 0, 0).getBytes(), 0);
+    if (telegram == 0) {
+        return false;
+    }
+    telegram->createChecksum();
+    return sendMessage(telegram);    
 }
 
 bool KnxTpUart::individualAnswerMaskVersion(int area, int line, int member) {
-    createKNXMessageFrameIndividual(4, KNX_COMMAND_MASK_VERSION_RESPONSE, PA_INTEGER(area, line, member), 0);
-    _tg->setCommunicationType(KNX_COMM_NDP);
-    _tg->setBufferByte(8, 0x07); // Mask version part 1 for BIM M 112
-    _tg->setBufferByte(9, 0x01); // Mask version part 2 for BIM M 112
-    _tg->createChecksum();
-    return sendMessage();
+    KnxTelegram* telegram = createKNXMessageFrameIndividual(4, KNX_COMMAND_MASK_VERSION_RESPONSE, KnxIndividualAddress(area, line, member).getBytes(), 0);
+    if (telegram == 0) {
+        return false;
+    }
+    telegram->setCommunicationType(KNX_COMM_NDP);
+    telegram->setBufferByte(8, 0x07); // Mask version part 1 for BIM M 112
+    telegram->setBufferByte(9, 0x01); // Mask version part 2 for BIM M 112
+    telegram->createChecksum();
+    return sendNumbered(telegram);
 }
 
 bool KnxTpUart::individualAnswerAuth(int accessLevel, int sequenceNo, int area, int line, int member) {
-    createKNXMessageFrameIndividual(3, KNX_COMMAND_ESCAPE, PA_INTEGER(area, line, member), KNX_EXT_COMMAND_AUTH_RESPONSE);
-    _tg->setCommunicationType(KNX_COMM_NDP);
-    _tg->setSequenceNumber(sequenceNo);
-    _tg->setBufferByte(8, accessLevel);
-    _tg->createChecksum();
-    return sendMessage();
-}
-
-void KnxTpUart::createKNXMessageFrame(int payloadlength, KnxCommandType command, byte groupAddress[2], int firstDataByte) {
-    _tg->clear();
-    _tg->setSourceAddress(_individualAddress);
-    _tg->setTargetGroupAddress(groupAddress);
-    _tg->setFirstDataByte(firstDataByte);
-    _tg->setCommand(command);
-    _tg->setPayloadLength(payloadlength);
-    _tg->createChecksum();
-}
-
-void KnxTpUart::createKNXMessageFrameIndividual(int payloadlength, KnxCommandType command, byte targetIndividualAddress[2], int firstDataByte) {
-    _tg->clear();
-    _tg->setSourceAddress(_individualAddress);
-    _tg->setTargetIndividualAddress(targetIndividualAddress);
-    _tg->setFirstDataByte(firstDataByte);
-    _tg->setCommand(command);
-    _tg->setPayloadLength(payloadlength);
-    _tg->createChecksum();
-}
-
-bool KnxTpUart::sendNCDPosConfirm(int sequenceNo, byte targetIndividualAddress[2]) {
-    _tg_ptp->clear();
-    _tg_ptp->setSourceAddress(_individualAddress);
-    _tg_ptp->setTargetIndividualAddress(targetIndividualAddress);
-    _tg_ptp->setSequenceNumber(sequenceNo);
-    _tg_ptp->setCommunicationType(KNX_COMM_NCD);
-    _tg_ptp->setControlData(KNX_CONTROLDATA_POS_CONFIRM);
-    _tg_ptp->setPayloadLength(1);
-    _tg_ptp->createChecksum();
-    
-    
-    int messageSize = _tg_ptp->getTotalLength();
-    
-    uint8_t sendbuf[2];
-    for (int i = 0; i < messageSize; i++) {
-        if (i == (messageSize - 1)) {
-            sendbuf[0] = TPUART_DATA_END;
-        } else {
-            sendbuf[0] = TPUART_DATA_START_CONTINUE;
-        }
-        
-        sendbuf[0] |= i;
-        sendbuf[1] = _tg_ptp->getBufferByte(i);
-        
-        _serialport->write(sendbuf, 2);
+    KnxTelegram* telegram = createKNXMessageFrameIndividual(3, KNX_COMMAND_ESCAPE, KnxIndividualAddress(area, line, member).getBytes(), KNX_EXT_COMMAND_AUTH_RESPONSE);
+    if (telegram == 0) {
+        return false;
     }
-    
-    
-    int confirmation;
-    while(true) {
-        confirmation = serialRead();
-        if (confirmation == B10001011) {
-            return true; // Sent successfully
-        } else if (confirmation == B00001011) {
-            return false;
-        } else if (confirmation == -1) {
-            // Read timeout
-            return false;
-        }
+    telegram->setCommunicationType(KNX_COMM_NDP);
+    telegram->setSequenceNumber(sequenceNo);
+    telegram->setBufferByte(8, accessLevel);
+    telegram->createChecksum();
+    return sendNumbered(telegram);
+}
+
+KnxTelegram* KnxTpUart::createKNXMessageFrame(int payloadlength, KnxCommandType command, byte groupAddress[2], int firstDataByte) {
+    KnxTelegram* telegram = _telegram_pool.allocate();
+    if (telegram == 0) {
+#if defined(TPUART_DEBUG)
+        TPUART_DEBUG_PORT.println("Telegram pool exhausted, cannot send telegram");
+#endif
+        return 0;
     }
-    
-    return false;
+
+    telegram->setSourceAddress(_individualAddress);
+    telegram->setTargetGroupAddress(groupAddress);
+    telegram->setFirstDataByte(firstDataByte);
+    telegram->setCommand(command);
+    telegram->setPayloadLength(payloadlength);
+    telegram->createChecksum();
+    return telegram;
 }
 
-bool KnxTpUart::sendMessage() {
-    int messageSize = _tg->getTotalLength();
+KnxTelegram* KnxTpUart::createKNXMessageFrameIndividual(int payloadlength, KnxCommandType command, byte targetIndividualAddress[2], int firstDataByte) {
+    KnxTelegram* telegram = _telegram_pool.allocate();
+    if (telegram == 0) {
+#if defined(TPUART_DEBUG)
+        TPUART_DEBUG_PORT.println("Telegram pool exhausted, cannot send telegram");
+#endif
+        return 0;
+    }
 
-    uint8_t sendbuf[2];
-    for (int i = 0; i < messageSize; i++) {
-        if (i == (messageSize - 1)) {
-            sendbuf[0] = TPUART_DATA_END;
-        } else {
-            sendbuf[0] = TPUART_DATA_START_CONTINUE;
-        }
-        
-        sendbuf[0] |= i;
-        sendbuf[1] = _tg->getBufferByte(i);
-        
-        _serialport->write(sendbuf, 2);
+    telegram->setSourceAddress(_individualAddress);
+    telegram->setTargetIndividualAddress(targetIndividualAddress);
+    telegram->setFirstDataByte(firstDataByte);
+    telegram->setCommand(command);
+    telegram->setPayloadLength(payloadlength);
+    telegram->createChecksum();
+    return telegram;
+}
+
+/*
+ * T_Data_Connected to the partner of the transport connection goes through
+ * it, for its sequence number and repetitions; otherwise out as it is
+ */
+bool KnxTpUart::sendNumbered(KnxTelegram* telegram) {
+    if (telegram == 0) {
+        return false;
+    }
+    if (!_connection.isOpen() || _connection.getRemoteAddress() != telegram->getTargetIndividualAddress()) {
+        return sendMessage(telegram);
     }
 
+    bool queued = _connection.send(telegram);
+    _telegram_pool.release(telegram);
+    sendTransport();
+    return queued;
+}
 
-    int confirmation;
-    while(true) {
-        confirmation = serialRead();
-        if (confirmation == B10001011) {
-            delay (SERIAL_WRITE_DELAY_MS);
-            return true; // Sent successfully
-        } else if (confirmation == B00001011) {
-            delay (SERIAL_WRITE_DELAY_MS);
-            return false;
-        } else if (confirmation == -1) {
-            // Read timeout
-            delay (SERIAL_WRITE_DELAY_MS);
-            return false;
+void KnxTpUart::connect(KnxIndividualAddress remote) {
+    _connection.connect(remote);
+    sendTransport();
+}
+
+void KnxTpUart::disconnect() {
+    _connection.disconnect();
+    sendTransport();
+}
+
+bool KnxTpUart::sendConnected(KnxTelegram* telegram) {
+    if (!_connection.send(telegram)) {
+        return false;
+    }
+    sendTransport();
+    return true;
+}
+
+KnxTransportConnection* KnxTpUart::getTransportConnection() {
+    return &_connection;
+}
+
+/*
+ * Queues what the transport connection has to send as far as there is
+ * room, the rest waits in the connection for the next call
+ */
+void KnxTpUart::sendTransport() {
+    KnxTelegram control;
+    while (_connection.getControl(&control)) {
+        control.setSourceAddress(_individualAddress);
+        control.createChecksum();
+        if (sendTelegram(&control) < 0) {
+            return;
         }
+        _connection.controlSent();
     }
 
-    return false;
+    KnxTelegram* data = _connection.getData();
+    if (data != 0) {
+        data->setSourceAddress(_individualAddress);
+        data->createChecksum();
+        if (sendTelegram(data, _tx_callback, _tx_callback_context) >= 0) {
+            _connection.dataSent();
+        }
+    }
 }
 
-void KnxTpUart::sendAck() {
-    TPUART_DEBUG_PORT.print("Send ACK");
-    byte sendByte = B00010001;
-    _serialport->write(sendByte);
-    delay(SERIAL_WRITE_DELAY_MS);
+bool KnxTpUart::sendMessage(KnxTelegram* telegram) {
+    if (telegram == 0) {
+        return false;
+    }
+    return sendLeasedTelegram(telegram, _tx_callback, _tx_callback_context) >= 0;
 }
 
-void KnxTpUart::sendNotAddressed() {
-    byte sendByte = B00010000;
-    _serialport->write(sendByte);
-    delay(SERIAL_WRITE_DELAY_MS);
+void KnxTpUart::setTxCallback(KnxTxCallback callback, void* context) {
+    _tx_callback = callback;
+    _tx_callback_context = context;
 }
 
-int KnxTpUart::serialRead() {
-    unsigned long startTime = millis();
+void KnxTpUart::setTxCoalescing(bool on) {
+    _tx_coalescing = on;
+}
+
+bool KnxTpUart::setSendFilter(KnxGroupAddress groupAddress, unsigned int minIntervalMs) {
+    return _send_filters.add(groupAddress, minIntervalMs, 0, 0);
+}
+
+int KnxTpUart::sendTelegram(KnxTelegram* telegram, KnxTxCallback callback, void* context) {
+    if (telegram->getTotalLength() > MAX_KNX_TELEGRAM_SIZE) {
+        // Extended frames go through sendExtendedTelegram()
+        return -1;
+    }
+
+    KnxTelegram* leased = _telegram_pool.allocate();
+    if (leased == 0) {
 #if defined(TPUART_DEBUG)
-    TPUART_DEBUG_PORT.print("Available: ");
-    TPUART_DEBUG_PORT.println(_serialport->available());
+        TPUART_DEBUG_PORT.println("Telegram pool exhausted, cannot send telegram");
 #endif
-    
-    while (! (_serialport->available() > 0)) {
-        if (abs(millis() - startTime) > SERIAL_READ_TIMEOUT_MS) {
-            // Timeout
+        return -1;
+    }
+
+    *leased = *telegram;
+    return sendLeasedTelegram(leased, callback, context);
+}
+
+/*
+ * Sends a telegram leased from the pool, which goes with it: into the
+ * queue, or back to the pool if it was filtered or did not fit
+ */
+int KnxTpUart::sendLeasedTelegram(KnxTelegram* telegram, KnxTxCallback callback, void* context) {
+    if (telegram->getTotalLength() > MAX_KNX_TELEGRAM_SIZE) {
+        _telegram_pool.release(telegram);
+        return -1;
+    }
+
+    KnxSendFilter* filter = _send_filters.find(telegram);
+    if (filter != 0) {
+        if (!_send_filters.isChanged(filter, telegram)) {
+            // Close enough to the value on the bus, a held one is obsolete too
+            _telegram_pool.release(_send_filters.takeHeld(filter));
+            updateGroupObject(telegram);
+            _telegram_pool.release(telegram);
+            return TPUART_TX_COALESCED;
+        }
+        if (!_send_filters.isDue(filter)) {
+            // Keeps the lease, a held one is obsolete
+            _telegram_pool.release(_send_filters.hold(filter, telegram, callback, context));
+            updateGroupObject(telegram);
+            return TPUART_TX_COALESCED;
+        }
+    }
+
+    int handle = queueTelegram(telegram, callback, context, _tx_coalescing || filter != 0);
+    if (handle < 0) {
+        _telegram_pool.release(telegram);
+    } else if (filter != 0) {
+        _telegram_pool.release(_send_filters.takeHeld(filter));
+        _send_filters.sent(filter, telegram);
+    }
+    return handle;
+}
+
+/*
+ * Puts a leased telegram into a free slot, or with coalesce a group write
+ * over a pending write to the same group address. The slot owns it then.
+ */
+int KnxTpUart::queueTelegram(KnxTelegram* telegram, KnxTxCallback callback, void* context, bool coalesce) {
+    bool write = coalesce && telegram->isTargetGroup() && telegram->getCommand() == KNX_COMMAND_WRITE;
+    uint16_t groupAddress = write ? telegram->getTargetGroupAddress().getValue() : 0;
+
+    KnxTxSlot* slot = 0;
+    for (int i = 0; i < TPUART_TX_QUEUE_SIZE; i++) {
+        KnxTxSlot* candidate = &_tx_queue[i];
+        if (write && candidate->state == TPUART_TX_PENDING
+                && candidate->telegram != 0
+                && candidate->telegram->isTargetGroup()
+                && candidate->telegram->getCommand() == KNX_COMMAND_WRITE
+                && candidate->telegram->getTargetGroupAddress().getValue() == groupAddress) {
+            // Keeps its handle and place in the queue
+            updateGroupObject(telegram);
+            _telegram_pool.release(candidate->telegram);
+            candidate->telegram = telegram;
+            candidate->callback = callback;
+            candidate->callbackContext = context;
+            return candidate->handle;
+        }
+        if (slot == 0 && candidate->state == TPUART_TX_FREE) {
+            slot = candidate;
+            if (!write) {
+                break;
+            }
+        }
+    }
+
+    if (slot == 0) {
 #if defined(TPUART_DEBUG)
-            TPUART_DEBUG_PORT.println("Timeout while receiving message");
+        TPUART_DEBUG_PORT.println("Transmit queue full, cannot send telegram");
 #endif
-            return -1;
+        return -1;
+    }
+
+    updateGroupObject(telegram);
+
+    slot->telegram = telegram;
+    slot->extended = 0;
+    return enqueue(slot, callback, context);
+}
+
+int KnxTpUart::sendExtendedTelegram(KnxExtendedTelegram* telegram, KnxTxCallback callback, void* context) {
+    if (telegram == 0) {
+        return -1;
+    }
+
+    for (int i = 0; i < TPUART_TX_QUEUE_SIZE; i++) {
+        if (_tx_queue[i].state == TPUART_TX_FREE) {
+            _tx_queue[i].telegram = 0;
+            _tx_queue[i].extended = telegram;
+            return enqueue(&_tx_queue[i], callback, context);
         }
-        delay(1);
     }
-    
-    int inByte = _serialport->read();
-    checkErrors();
-    printByte(inByte);
-    
-    return inByte;
+
+#if defined(TPUART_DEBUG)
+    TPUART_DEBUG_PORT.println("Transmit queue full, cannot send telegram");
+#endif
+    _telegram_pool.release(telegram);
+    return -1;
 }
 
-void KnxTpUart::addListenGroupAddress(byte address[]) {
-    if (_listen_group_address_count >= MAX_LISTEN_GROUP_ADDRESSES) {
+/*
+ * Queues the telegram just put into a free slot
+ */
+int KnxTpUart::enqueue(KnxTxSlot* slot, KnxTxCallback callback, void* context) {
+    slot->state = TPUART_TX_PENDING;
+    slot->handle = _tx_next_handle;
+    slot->sequence = _tx_next_sequence++;
+    slot->attempts = 0;
+    slot->callback = callback;
+    slot->callbackContext = context;
+    _tx_next_handle = (_tx_next_handle + 1) % TPUART_TX_COALESCED;
+
+    startTx();
+
+    return slot->handle;
+}
+
+KnxTelegramView KnxTpUart::getTxView(KnxTxSlot* slot) {
+    if (slot->extended != 0) {
+        return slot->extended->getView();
+    }
+    return slot->telegram->getView();
+}
+
+int KnxTpUart::getTxQueueCount() {
+    int count = 0;
+    for (int i = 0; i < TPUART_TX_QUEUE_SIZE; i++) {
+        if (_tx_queue[i].state != TPUART_TX_FREE) {
+            count++;
+        }
+    }
+    return count;
+}
+
+void KnxTpUart::loop() {
+    sendHeldTelegrams();
+    _connection.loop();
+    sendTransport();
+
+    for (int i = 0; i < TPUART_TX_QUEUE_SIZE; i++) {
+        if (_tx_queue[i].state == TPUART_TX_SENDING) {
+            unsigned long timeout = TPUART_TX_CONFIRM_TIMEOUT_MS;
+            int length = getTxView(&_tx_queue[i]).getTotalLength();
+            if (length > MAX_KNX_TELEGRAM_SIZE) {
+                // Extended frames take longer on the serial line and on the bus
+                timeout = timeout * length / MAX_KNX_TELEGRAM_SIZE;
+            }
+            if (millis() - _tx_start_time > timeout) {
 #if defined(TPUART_DEBUG)
-        TPUART_DEBUG_PORT.println("Already listening to MAX_LISTEN_GROUP_ADDRESSES, cannot listen to another");
+                TPUART_DEBUG_PORT.println("Timeout while waiting for confirmation");
 #endif
+                finishTx(false);
+            }
+            return;
+        }
+    }
+
+    startTx();
+}
+
+void KnxTpUart::setTxAttempts(byte attempts) {
+    _tx_attempts = attempts > 0 ? attempts : 1;
+}
+
+const KnxTxStatistics* KnxTpUart::getTxStatistics(KnxGroupAddress groupAddress) {
+    return _tx_statistics.find(groupAddress);
+}
+
+const KnxTxStatistics* KnxTpUart::getTxStatistics() {
+    return _tx_statistics.getTotal();
+}
+
+void KnxTpUart::setTxBudget(KnxPriorityType priority, byte percent) {
+    _bus_load.setBudget(priority, percent);
+}
+
+void KnxTpUart::setBusLoadLimit(byte percent) {
+    _bus_load.setLoadLimit(percent);
+}
+
+byte KnxTpUart::getBusLoad() {
+    return _bus_load.getLoad();
+}
+
+/*
+ * Queues the telegrams held by send filters whose interval is over
+ */
+void KnxTpUart::sendHeldTelegrams() {
+    KnxSendFilter* filter;
+    while ((filter = _send_filters.findDue()) != 0) {
+        if (queueTelegram(filter->held, filter->heldCallback, filter->heldCallbackContext, true) < 0) {
+            // Queue full, next loop()
+            return;
+        }
+        // The queue owns the lease now
+        KnxTelegram* telegram = _send_filters.takeHeld(filter);
+        _send_filters.sent(filter, telegram);
+    }
+}
+
+/*
+ * Hands the next queued telegram to the TPUART, if no other telegram is
+ * waiting for its confirmation. Does not wait for the confirmation.
+ * Priorities are sent in the order system, alarm, high, normal, skipping
+ * those over their budget; they are retried from loop(). A retry goes
+ * first, nothing overtakes it while it waits for its delay.
+ */
+void KnxTpUart::startTx() {
+    if (_rx_state != TPUART_RX_IDLE) {
+        // Don't delay the ACK of the telegram being received
         return;
     }
-    
-    _listen_group_addresses[_listen_group_address_count][0]=address[0];
-    _listen_group_addresses[_listen_group_address_count][1]=address[1];
-    _listen_group_address_count++;
+    if (_monitor != 0) {
+        // Queued telegrams wait for the end of the bus monitor mode
+        return;
+    }
+
+    KnxTxSlot* next = 0;
+    KnxTxSlot* retry = 0;
+    for (int i = 0; i < TPUART_TX_QUEUE_SIZE; i++) {
+        KnxTxSlot* slot = &_tx_queue[i];
+        if (slot->state == TPUART_TX_SENDING) {
+            // Only one telegram at a time can be handed to the TPUART
+            return;
+        }
+        if (slot->state == TPUART_TX_RETRY) {
+            retry = slot;
+            continue;
+        }
+        if (slot->state != TPUART_TX_PENDING
+                || !_bus_load.maySend(getTxView(slot).getTotalLength(), getTxView(slot).getPriority())) {
+            continue;
+        }
+        if (next == 0) {
+            next = slot;
+            continue;
+        }
+
+        byte rank = KnxBusLoad::priorityClass(getTxView(slot).getPriority());
+        byte nextRank = KnxBusLoad::priorityClass(getTxView(next).getPriority());
+        if (rank < nextRank || (rank == nextRank && (int)(slot->sequence - next->sequence) < 0)) {
+            next = slot;
+        }
+    }
+
+    if (retry != 0) {
+        if ((long) (millis() - retry->retryTime) < 0
+                || !_bus_load.maySend(getTxView(retry).getTotalLength(), getTxView(retry).getPriority())) {
+            return;
+        }
+        next = retry;
+    }
+
+    if (next == 0) {
+        return;
+    }
+
+    writeFrame(getTxView(next));
+
+    next->state = TPUART_TX_SENDING;
+    next->attempts++;
+    _tx_start_time = millis();
+}
+
+/*
+ * Writes a frame as U_L_DataStart/U_L_DataContinue/U_L_DataEnd sequence:
+ * one service byte with the index followed by the data byte, for each byte.
+ * From byte 64 of extended frames on, U_L_DataOffset (TPUART2) gives the
+ * upper bits of the index. A standard frame goes out in one write, one
+ * syscall / USB transfer on hosts.
+ */
+void KnxTpUart::writeFrame(KnxTelegramView frame) {
+    uint8_t sendbuf[2 * MAX_KNX_TELEGRAM_SIZE + 1];
+    int sendSize = 0;
+    int messageSize = frame.getTotalLength();
+
+    for (int i = 0; i < messageSize; i++) {
+        if (sendSize + 3 > (int) sizeof(sendbuf)) {
+            _serialport->write(sendbuf, sendSize);
+            sendSize = 0;
+        }
+
+        if (i > 0 && (i & TPUART_DATA_INDEX_MASK) == 0) {
+            sendbuf[sendSize++] = TPUART2_DATA_OFFSET | (i >> 6);
+        }
+        if (i == (messageSize - 1)) {
+            sendbuf[sendSize] = TPUART_DATA_END;
+        } else {
+            sendbuf[sendSize] = TPUART_DATA_START_CONTINUE;
+        }
+
+        sendbuf[sendSize++] |= i & TPUART_DATA_INDEX_MASK;
+        sendbuf[sendSize++] = frame.getBufferByte(i);
+    }
+
+    _serialport->write(sendbuf, sendSize);
+}
 
 /*
+ * Completes the telegram waiting for its confirmation and starts the next one
+ */
+void KnxTpUart::finishTx(bool success) {
+    KnxTxSlot* slot = 0;
+    for (int i = 0; i < TPUART_TX_QUEUE_SIZE; i++) {
+        if (_tx_queue[i].state == TPUART_TX_SENDING) {
+            slot = &_tx_queue[i];
+            break;
+        }
+    }
+
+    if (slot == 0) {
+        // Not sent by us
+        return;
+    }
+
+    _bus_load.addOwnFrame(getTxView(slot).getTotalLength(), getTxView(slot).getPriority(), success);
+
+    if (!success && slot->attempts < _tx_attempts) {
+        // The TPUART repeated it already, give the bus some time
+        unsigned long wait = (unsigned long) TPUART_TX_RETRY_DELAY_MS << (slot->attempts - 1);
+        wait += wait * _bus_load.getLoad() / 50;
+
+        if (slot->extended != 0) {
+            slot->extended->setRepeated(true);
+            slot->extended->createChecksum();
+        } else {
+            slot->telegram->setRepeated(true);
+            slot->telegram->createChecksum();
+        }
+        slot->state = TPUART_TX_RETRY;
+        slot->retryTime = millis() + wait;
+        _tx_statistics.addRetry(getTxView(slot));
+        return;
+    }
+
+    if (success) {
+        _tx_statistics.addConfirmed(getTxView(slot));
+    } else {
+        _tx_statistics.addFailed(getTxView(slot));
+    }
+
+    // Free the slot before the callback, so it can queue the next telegram
+    _telegram_pool.release(slot->telegram);
+    _telegram_pool.release(slot->extended);
+    slot->telegram = 0;
+    slot->extended = 0;
+    slot->state = TPUART_TX_FREE;
+
+    if (slot->callback != 0) {
+        slot->callback(slot->handle, success, slot->callbackContext);
+    }
+
+    startTx();
+}
+
+void KnxTpUart::sendAck() {
 #if defined(TPUART_DEBUG)
+    TPUART_DEBUG_PORT.println("Send ACK");
+#endif
+    sendAckInformation(true, false, false);
+}
 
-    for (int i = 0; i < _listen_group_address_count; i++) {
+void KnxTpUart::sendNotAddressed() {
+    sendAckInformation(false, false, false);
+}
 
-        TPUART_DEBUG_PORT.print("Listen for: [");
-        TPUART_DEBUG_PORT.print(i);
-        TPUART_DEBUG_PORT.print("] -> ");
-        TPUART_DEBUG_PORT.print(_listen_group_addresses[i][0]);
-        TPUART_DEBUG_PORT.print("/");
-        TPUART_DEBUG_PORT.print(_listen_group_addresses[i][1]);
-        TPUART_DEBUG_PORT.print("/");
-        TPUART_DEBUG_PORT.print(_listen_group_addresses[i][2]);
-        TPUART_DEBUG_PORT.println("");
+/*
+ * U_AckInformation: addressed = ACK, busy = BUSY, nack = NACK on the bus
+ */
+void KnxTpUart::sendAckInformation(bool addressed, bool busy, bool nack) {
+    byte sendByte = TPUART_ACK_INFORMATION;
+    if (addressed) {
+        sendByte |= TPUART_ACK_ADDRESSED;
     }
+    if (busy) {
+        sendByte |= TPUART_ACK_BUSY;
+    }
+    if (nack) {
+        sendByte |= TPUART_ACK_NACK;
+    }
+    _serialport->write(sendByte);
+}
 
+void KnxTpUart::addListenGroupAddress(byte address[]) {
+    if (_listen_group_addresses.add(address) < 0) {
+#if defined(TPUART_DEBUG)
+        TPUART_DEBUG_PORT.println("Already listening to MAX_LISTEN_GROUP_ADDRESSES, cannot listen to another");
 #endif
-*/
+    }
+}
+
+void KnxTpUart::addListenGroupAddress(KnxGroupAddress address) {
+    addListenGroupAddress(address.getBytes());
+}
+
+/*
+ * Listen to all group addresses main/x/x
+ */
+void KnxTpUart::addListenMainGroup(int mainGroup) {
+    _listen_group_addresses.addMainGroup(mainGroup);
+}
 
+/*
+ * Listen to all group addresses main/middle/x
+ */
+void KnxTpUart::addListenMiddleGroup(int mainGroup, int middleGroup) {
+    _listen_group_addresses.addMiddleGroup(mainGroup, middleGroup);
 }
 
 bool KnxTpUart::isListeningToGroupAddress(byte address[2]) {
-    
+    return _listen_group_addresses.contains(address);
+}
 
-    for (int i = 0; i < _listen_group_address_count; i++) {
-    
-        if ( (_listen_group_addresses[i][0] == address[0])
-                && (_listen_group_addresses[i][1] == address[1])) {
-            return true;
-        }
+bool KnxTpUart::isListeningToGroupAddress(KnxGroupAddress address) {
+    return isListeningToGroupAddress(address.getBytes());
+}
+
+bool KnxTpUart::addGroupHandler(byte groupAddress[2], KnxCommandType command, KnxGroupHandler handler, void* context) {
+    int index = _listen_group_addresses.add(groupAddress);
+    if (index < 0) {
+#if defined(TPUART_DEBUG)
+        TPUART_DEBUG_PORT.println("Already listening to MAX_LISTEN_GROUP_ADDRESSES, cannot add handler");
+#endif
+        return false;
     }
+    return _group_handlers.add(index, command, handler, context);
+}
+
+bool KnxTpUart::addGroupHandler(KnxGroupAddress groupAddress, KnxCommandType command, KnxGroupHandler handler, void* context) {
+    return addGroupHandler(groupAddress.getBytes(), command, handler, context);
+}
+
+bool KnxTpUart::addGroupObject(byte groupAddress[2], bool notifyRead) {
+    int index = _listen_group_addresses.add(groupAddress);
+    if (index < 0) {
+#if defined(TPUART_DEBUG)
+        TPUART_DEBUG_PORT.println("Already listening to MAX_LISTEN_GROUP_ADDRESSES, cannot add group object");
+#endif
+        return false;
+    }
+    return _group_objects.add(index, notifyRead ? KNX_GROUP_OBJECT_NOTIFY_READ : 0);
+}
 
-    return false;
+bool KnxTpUart::addGroupObject(KnxGroupAddress groupAddress, bool notifyRead) {
+    return addGroupObject(groupAddress.getBytes(), notifyRead);
 }
@@ -5,13 +5,37 @@
 #include "Arduino.h"
 
 #include "KnxTelegram.h"
+#include "KnxGroupAddressFilter.h"
+#include "KnxGroupHandlerTable.h"
+#include "KnxGroupObjectTable.h"
+#include "KnxPreparedTelegram.h"
+#include "KnxMonitorBuffer.h"
+#include "KnxBusLoad.h"
+#include "KnxSendFilterTable.h"
+#include "KnxTxCallback.h"
+#include "KnxTxStatistics.h"
+#include "KnxRxRing.h"
+#include "KnxTelegramPool.h"
+#include "KnxTransportConnection.h"
 
 // Services from TPUART
 #define TPUART_RESET_INDICATION_BYTE B11
+#define TPUART_DATA_CONFIRM_SUCCESS B10001011
+#define TPUART_DATA_CONFIRM_FAILED B00001011
 
 // Services to TPUART
+#define TPUART_ACTIVATE_BUSMON 0x05        // U_ActivateBusmon, left with U_Reset
 #define TPUART_DATA_START_CONTINUE B10000000
 #define TPUART_DATA_END B01000000
+#define TPUART_DATA_INDEX_MASK B00111111
+#define TPUART_ACK_INFORMATION B00010000   // U_AckInformation, or'ed with the flags below
+#define TPUART_ACK_ADDRESSED B001
+#define TPUART_ACK_BUSY B010
+#define TPUART_ACK_NACK B100
+
+// Services to TPUART2 only
+#define TPUART2_SET_ADDRESS 0xF1           // U_SetAddress, followed by 2 address bytes
+#define TPUART2_DATA_OFFSET 0x08           // U_L_DataOffset, or'ed with index / 64 of the next bytes
 
 // Debugging
 // uncomment the following line to enable debugging
@@ -20,17 +44,42 @@
 
 #define TPUART_SERIAL_CLASS Stream
 
-// Delay in ms between sending of packets to the bus
-// set to 0 if you keep care of that by yourself
-#define SERIAL_WRITE_DELAY_MS 0
-
-// Timeout for reading a byte from TPUART
+// A gap this long between two bytes of a telegram ends it
 #define SERIAL_READ_TIMEOUT_MS 10
 
-// Maximum number of group addresses that can be listened on
-#define MAX_LISTEN_GROUP_ADDRESSES 48
+// Number of telegrams that can be queued for sending
+#define TPUART_TX_QUEUE_SIZE 4
+
+// Timeout for the TPUART confirmation (L_DATA.con) of a sent telegram,
+// longer extended frames wait in proportion to their length
+#define TPUART_TX_CONFIRM_TIMEOUT_MS 300
+
+// Attempts to send a telegram the TPUART did not confirm (it was not
+// acknowledged on the bus after the repetitions of the TPUART, or the
+// confirmation timed out). Retries have the repeat flag set.
+#ifndef TPUART_TX_ATTEMPTS
+#define TPUART_TX_ATTEMPTS 3
+#endif
+
+// Delay before the first retry, doubles with every further one and grows
+// with the bus load
+#ifndef TPUART_TX_RETRY_DELAY_MS
+#define TPUART_TX_RETRY_DELAY_MS 20
+#endif
+
+// 1: a group write replaces a queued, not yet sent write to the same group
+// address (last value wins), see setTxCoalescing()
+#ifndef TPUART_TX_COALESCE
+#define TPUART_TX_COALESCE 0
+#endif
+
+// Returned by sendTelegram() for a write a send filter held back or dropped,
+// its callback is not called
+#define TPUART_TX_COALESCED 0x7FFF
 
 // Macros for converting PA and GA to 2-byte
+// PA_STRING/GA_STRING parse at runtime on the heap, prefer the typed addresses
+// from KnxAddress.h for constant addresses: "15.15.20"_pa, "0/0/3"_ga
 #define PA_INTEGER(area, line, member) (byte*)(const byte[]){(area << 4) | line, member}
 #define PA_STRING(address) (byte*)(const byte[]){(String(address).substring(0, String(address).indexOf('.')).toInt() << 4) | String(address).substring(String(address).indexOf('.')+1, String(address).lastIndexOf('.')).toInt(), String(address).substring(String(address).lastIndexOf('.')+1,String(address).length()).toInt()}
 
@@ -43,23 +92,154 @@ enum KnxTpUartSerialEventType {
     TPUART_RESET_INDICATION,
     KNX_TELEGRAM,
     IRRELEVANT_KNX_TELEGRAM,
-    UNKNOWN
+    UNKNOWN,
+    INCOMPLETE_KNX_TELEGRAM, // bytes consumed, telegram not complete yet
+    TPUART_DATA_CONFIRM,     // confirmation for a sent telegram (L_DATA.con)
+    KNX_MONITOR_FRAME,       // frame stored in the monitor buffer (bus monitor mode)
+    KNX_GROUP_READ_ANSWERED, // read request answered from the group object cache
+    KNX_TELEGRAM_ERROR,      // wrong checksum, or ended by a gap; following telegrams are searched in its bytes
+    KNX_EXTENDED_TELEGRAM    // extended frame for us, see getReceivedExtendedTelegram()
+};
+
+// States of the byte-fed receive state machine
+enum KnxTpUartRxState {
+    TPUART_RX_IDLE,         // waiting for a control byte or service byte
+    TPUART_RX_TELEGRAM      // inside a telegram, collecting header/payload/checksum
+};
+
+// States of a slot in the transmit queue
+enum KnxTxSlotState {
+    TPUART_TX_FREE,
+    TPUART_TX_PENDING,      // queued, waiting for its turn
+    TPUART_TX_SENDING,      // handed to the TPUART, waiting for L_DATA.con
+    TPUART_TX_RETRY         // not confirmed, waiting for the next attempt
+};
+
+// Called for every event serialEvent() reports, with the bytes of the event
+// (the whole telegram, or the service byte) and the micros() its first byte
+// was received
+typedef void (*KnxRxEventCallback)(KnxTpUartSerialEventType eventType, const byte* data, int length, unsigned long time, void* context);
+
+struct KnxTxSlot {
+    KnxTelegram* telegram;  // leased from the pool while the slot is used
+    KnxExtendedTelegram* extended;  // instead of telegram for an extended frame
+    KnxTxSlotState state;
+    int handle;
+    unsigned int sequence;  // enqueue order, keeps FIFO within a priority
+    byte attempts;          // times handed to the TPUART
+    unsigned long retryTime;    // millis() of the next attempt
+    KnxTxCallback callback;
+    void* callbackContext;
 };
 
 class KnxTpUart {
 public:
     KnxTpUart(TPUART_SERIAL_CLASS*, byte*);
+    KnxTpUart(TPUART_SERIAL_CLASS*, KnxIndividualAddress);
     void uartReset();
     void uartStateRequest();
     KnxTpUartSerialEventType serialEvent();
-    KnxTelegram* getReceivedTelegram(); 
+    // Telegram of the last KNX_TELEGRAM, overwritten by the next one
+    KnxTelegram* getReceivedTelegram();
+    // Takes the telegram of the last KNX_TELEGRAM over: it stays as it is
+    // until given back with releaseTelegram(). 0 if the pool is exhausted.
+    KnxTelegram* takeReceivedTelegram();
+    void releaseTelegram(KnxTelegram*);
+    // Telegrams left in the pool (see KnxTelegramPool.h), and the number of
+    // times none was left for receiving, sending or taking a telegram
+    int getFreeTelegramCount();
+    unsigned long getTelegramPoolExhaustedCount();
+
+    // Extended frames use the extended telegrams of the pool. Without a free
+    // one, extended frames for us are answered with BUSY, so they are repeated.
+    // Telegram of the last KNX_EXTENDED_TELEGRAM, overwritten by the next one
+    KnxExtendedTelegram* getReceivedExtendedTelegram();
+    // Takes it over without copying, 0 until the next one is received
+    KnxExtendedTelegram* takeReceivedExtendedTelegram();
+    // Empty one from the pool to send, 0 if the pool is exhausted
+    KnxExtendedTelegram* allocateExtendedTelegram();
+    void releaseTelegram(KnxExtendedTelegram*);
+    int getFreeExtendedTelegramCount();
+    // Queues a telegram from allocateExtendedTelegram(), which goes back to
+    // the pool once it was sent or could not be queued. Returns the handle,
+    // or -1 like sendTelegram().
+    int sendExtendedTelegram(KnxExtendedTelegram* telegram, KnxTxCallback callback = 0, void* context = 0);
 
     void setIndividualAddress(byte*);
+    void setIndividualAddress(KnxIndividualAddress);
     void getIndividualAddress(byte address[2]);
+    KnxIndividualAddress getIndividualAddress();
     
     void sendAck();
     void sendNotAddressed();
-    
+    void sendAckInformation(bool addressed, bool busy, bool nack);
+
+    // TPUART2 only: program the individual address into the chip, which then
+    // acknowledges telegrams to it by itself. Group telegrams are still
+    // acknowledged by us.
+    void setHardwareAddressMode(bool);
+
+    // Bus monitor mode: the TPUART passes every frame and acknowledge on the
+    // bus, we neither acknowledge nor send. Frames go into the buffer instead
+    // of getReceivedTelegram(). 0 ends the mode (resets the TPUART).
+    // Extended frames keep their first MAX_KNX_TELEGRAM_SIZE bytes there,
+    // flagged KNX_MONITOR_PARTIAL; the checksum is checked over all of them.
+    void setMonitorMode(KnxMonitorBuffer*);
+    bool isMonitorMode();
+
+    // Received bytes are read from the ring, filled by an interrupt, instead
+    // of the serial port (see KnxRxRing.h). Frames that arrived while the
+    // application was busy are returned by the next calls of serialEvent().
+    // 0 reads from the serial port again.
+    void setRxRing(KnxRxRing*);
+
+    // Must be called regularly (e.g. from loop()) to handle confirmation timeouts
+    void loop();
+
+    // Queue a telegram for sending. Returns a handle which is passed to the
+    // callback once the TPUART confirmed the telegram, or -1 if the queue is full
+    // or the telegram doesn't fit MAX_KNX_TELEGRAM_SIZE.
+    // A write that replaced a queued one gets its handle, the callback of the
+    // newer write is called.
+    int sendTelegram(KnxTelegram* telegram, KnxTxCallback callback = 0, void* context = 0);
+    // Callback used for telegrams queued by the groupWrite/groupAnswer/individual methods
+    void setTxCallback(KnxTxCallback callback, void* context);
+    int getTxQueueCount();
+
+    // Attempts per telegram, 1 = no retries. The callback is called once,
+    // after the last attempt.
+    void setTxAttempts(byte attempts);
+    // Delivery counters of a group address, 0 if nothing was sent to it
+    const KnxTxStatistics* getTxStatistics(KnxGroupAddress groupAddress);
+    // of all telegrams
+    const KnxTxStatistics* getTxStatistics();
+
+    // Queued telegrams are sent while they fit into the budget of their
+    // priority, in percent of the bus time (see KnxBusLoad.h for defaults
+    // and the window). Normal priority also waits while the bus load is
+    // above the limit.
+    void setTxBudget(KnxPriorityType priority, byte percent);
+    void setBusLoadLimit(byte percent);
+    // Estimated from the traffic on the bus, in percent
+    byte getBusLoad();
+
+    // Group writes replace queued writes to the same group address
+    void setTxCoalescing(bool);
+    // Writes to groupAddress are coalesced and sent at most once per
+    // minIntervalMs: an earlier one is held in its telegram from the pool and
+    // sent from loop(), unless a newer one replaces it. With a DPT, only values differing by at least
+    // threshold from the last one sent, e.g.
+    // setSendFilter<Dpt<9, 1> >("0/0/3"_ga, 1000, 0.2) for temperatures.
+    // Returns false if the table is full.
+    bool setSendFilter(KnxGroupAddress groupAddress, unsigned int minIntervalMs);
+    template<class D> bool setSendFilter(KnxGroupAddress groupAddress, unsigned int minIntervalMs, float threshold) {
+        return _send_filters.add(groupAddress, minIntervalMs, threshold, KnxSendFilterTable::decodeValue<D>);
+    }
+
+    // Observer of all received events, relevant or not, e.g. for recording the bus
+    void setRxEventCallback(KnxRxEventCallback callback, void* context);
+
+    // groupWrite/groupAnswer/individual methods return true if the telegram was queued
     bool groupWriteBool(byte* groupAddress, bool);
     bool groupWrite2ByteFloat(byte* groupAddress, float);
     bool groupWrite1ByteInt(byte* groupAddress, int);
@@ -75,14 +255,95 @@ public:
     bool groupAnswer14ByteText(byte* groupAddress, String);
     
     bool groupWriteTime(byte* groupAddress, int, int, int, int);
+
+    // Telegrams sent periodically to the same group address: prepare once,
+    // then only set the value and send
+    void prepareGroupTelegram(KnxPreparedTelegram*, KnxCommandType, byte* groupAddress, int payloadLength);
+    bool sendPrepared(KnxPreparedTelegram*);
+
+    // Typed addresses, e.g. groupWriteBool("0/0/3"_ga, true)
+    bool groupWriteBool(KnxGroupAddress groupAddress, bool);
+    bool groupWrite2ByteFloat(KnxGroupAddress groupAddress, float);
+    bool groupWrite1ByteInt(KnxGroupAddress groupAddress, int);
+    bool groupWrite2ByteInt(KnxGroupAddress groupAddress, int);
+    bool groupWrite4ByteFloat(KnxGroupAddress groupAddress, float);
+    bool groupWrite14ByteText(KnxGroupAddress groupAddress, String);
+
+    bool groupAnswerBool(KnxGroupAddress groupAddress, bool);
+    bool groupAnswer2ByteFloat(KnxGroupAddress groupAddress, float);
+    bool groupAnswer1ByteInt(KnxGroupAddress groupAddress, int);
+    bool groupAnswer2ByteInt(KnxGroupAddress groupAddress, int);
+    bool groupAnswer4ByteFloat(KnxGroupAddress groupAddress, float);
+    bool groupAnswer14ByteText(KnxGroupAddress groupAddress, String);
+
+    bool groupWriteTime(KnxGroupAddress groupAddress, int, int, int, int);
+
+    void prepareGroupTelegram(KnxPreparedTelegram*, KnxCommandType, KnxGroupAddress groupAddress, int payloadLength);
+
+    // Any DPT, e.g. groupWrite<Dpt<5, 1> >("0/0/3"_ga, 50) for 50%
+    template<class D> bool groupWrite(KnxGroupAddress groupAddress, const typename D::Type& value) {
+        KnxTelegram* telegram = createKNXMessageFrame(D::PAYLOAD_LENGTH, KNX_COMMAND_WRITE, groupAddress.getBytes(), 0);
+        if (telegram == 0) {
+            return false;
+        }
+        telegram->setValue<D>(value);
+        telegram->createChecksum();
+        return sendMessage(telegram);
+    }
+
+    template<class D> bool groupAnswer(KnxGroupAddress groupAddress, const typename D::Type& value) {
+        KnxTelegram* telegram = createKNXMessageFrame(D::PAYLOAD_LENGTH, KNX_COMMAND_ANSWER, groupAddress.getBytes(), 0);
+        if (telegram == 0) {
+            return false;
+        }
+        telegram->setValue<D>(value);
+        telegram->createChecksum();
+        return sendMessage(telegram);
+    }
+
+    // Prepared for setValue<D>(), e.g. prepareGroupTelegram<Dpt<9> >(&prepared, KNX_COMMAND_WRITE, "0/0/3"_ga)
+    template<class D> void prepareGroupTelegram(KnxPreparedTelegram* prepared, KnxCommandType command, KnxGroupAddress groupAddress) {
+        prepareGroupTelegram(prepared, command, groupAddress, D::PAYLOAD_LENGTH);
+    }
     
     void addListenGroupAddress(byte* groupAddress);  
+    void addListenGroupAddress(KnxGroupAddress groupAddress);
+    void addListenMainGroup(int mainGroup);
+    void addListenMiddleGroup(int mainGroup, int middleGroup);
     bool isListeningToGroupAddress(byte* groupAddress);
+    bool isListeningToGroupAddress(KnxGroupAddress groupAddress);
+
+    // Listens to groupAddress and calls handler for received telegrams to it
+    // with command (read, write or answer), before serialEvent() reports them.
+    // Returns false if no more addresses or handlers can be added.
+    bool addGroupHandler(byte* groupAddress, KnxCommandType command, KnxGroupHandler handler, void* context = 0);
+    bool addGroupHandler(KnxGroupAddress groupAddress, KnxCommandType command, KnxGroupHandler handler, void* context = 0);
+
+    // Listens to groupAddress and caches its last value: sent with groupWrite/
+    // groupAnswer/sendTelegram or received in a write or answer. Read requests
+    // are answered from the cache in serialEvent(), which reports them as
+    // KNX_GROUP_READ_ANSWERED, or as KNX_TELEGRAM (and to the read handler)
+    // with notifyRead. Reads before the first value go to the application.
+    bool addGroupObject(byte* groupAddress, bool notifyRead = false);
+    bool addGroupObject(KnxGroupAddress groupAddress, bool notifyRead = false);
     
+    // Sent through the transport connection while it is open to the target,
+    // which sets the sequence number
     bool individualAnswerAddress();
     bool individualAnswerMaskVersion(int, int, int);
     bool individualAnswerAuth(int, int, int, int, int);
 
+    // Connection-oriented point-to-point communication, one connection at a
+    // time (see KnxTransportConnection.h). A remote device connects by
+    // itself. T_Data_Connected is acknowledged and reported as KNX_TELEGRAM
+    // once; control telegrams and repetitions are not reported.
+    void connect(KnxIndividualAddress remote);
+    void disconnect();
+    // T_Data_Connected to the partner with the APDU of telegram. False while
+    // no connection is open or the last one still waits for its T_ACK.
+    bool sendConnected(KnxTelegram* telegram);
+    KnxTransportConnection* getTransportConnection();
+
     bool sendPropertyResponse(byte* /*address (PA of origin)*/, int /*object*/, int /*propertyid*/, int /*start*/, int /*size of data*/, byte* /*data array*/);
 
     void setListenToBroadcasts(bool);
@@ -92,22 +353,83 @@ public:
     
 private:
     Stream* _serialport;
-    KnxTelegram* _tg;       // for normal communication
-    KnxTelegram* _tg_ptp;   // for PTP sequence confirmation
+    KnxTelegramPool _telegram_pool;
+    KnxTelegram _tg_rx;     // telegram currently being received
+    KnxTelegram* _rx_telegram;  // leased, last complete telegram
+    KnxExtendedTelegram* _rx_extended;  // leased, extended frame being received
+    KnxExtendedTelegram* _rx_extended_telegram; // leased, last complete extended frame
+    KnxTpUartRxState _rx_state;
+    int _rx_pos;
+    int _rx_length;
+    byte _rx_checksum;      // XOR of the bytes of the frame so far, stored or not
+    unsigned long _rx_last_byte_time;
+    unsigned long _rx_start_time;
+    KnxRxEventCallback _rx_event_callback;
+    void* _rx_event_callback_context;
+    bool _rx_interested;
+    byte _rx_replay[MAX_KNX_TELEGRAM_SIZE];     // bytes of a rejected frame, fed again
+    byte _rx_replay_pos;
+    byte _rx_replay_length;
+    int _rx_replay_gap;     // position in _rx_replay that followed a gap, -1 if none
+    bool _rx_resync;        // frame started in replayed bytes
+    KnxRxRing* _rx_ring;
+    const byte* _rx_ring_data;      // run of bytes peeked from the ring
+    const uint16_t* _rx_ring_times;
+    int _rx_ring_pos;
+    int _rx_ring_count;
+    uint16_t _rx_ring_last_time;    // KnxRxRing::time() of the last byte read
+    unsigned long _rx_ring_empty_time;  // micros() the ring was last found empty
+    int _rx_group_index;    // in _listen_group_addresses, -1 if not a single listened address
+    KnxTxSlot _tx_queue[TPUART_TX_QUEUE_SIZE];
+    int _tx_next_handle;
+    unsigned int _tx_next_sequence;
+    unsigned long _tx_start_time;
+    KnxBusLoad _bus_load;
+    byte _tx_attempts;
+    KnxTxStatisticsTable _tx_statistics;
+    bool _tx_coalescing;
+    KnxSendFilterTable _send_filters;
+    KnxTransportConnection _connection;
+    KnxTxCallback _tx_callback;
+    void* _tx_callback_context;
     byte _individualAddress[2];
-    byte _listen_group_addresses[MAX_LISTEN_GROUP_ADDRESSES][2];
-    byte _listen_group_address_count;
+    KnxGroupAddressFilter _listen_group_addresses;
+    KnxGroupHandlerTable _group_handlers;
+    KnxGroupObjectTable _group_objects;
     bool _listen_to_broadcasts;
+    bool _hardware_address_mode;
+    KnxMonitorBuffer* _monitor;
     
     bool isKNXControlByte(int);
+    void sendUartAddress();
     void checkErrors();
     void printByte(int);
-    bool readKNXTelegram();
-    void createKNXMessageFrame(int, KnxCommandType, byte* targetGroupAddress, int);
-    void createKNXMessageFrameIndividual(int, KnxCommandType, byte* targetIndividualAddress, int);
-    bool sendMessage();
-    bool sendNCDPosConfirm(int, byte* targetIndividualAddress);
-    int serialRead();
+    KnxTpUartSerialEventType readEvent();
+    KnxTpUartSerialEventType processRxByte(int, bool late);
+    KnxTpUartSerialEventType rejectFrame(byte monitorFlags, bool gap);
+    void setRxByte(int index, int content);
+    int getRxByte(int index);
+    KnxTpUartSerialEventType completeExtendedFrame();
+    void notifyRxEvent(KnxTpUartSerialEventType, int incomingByte);
+    void pushMonitorFrame(byte flags, int length);
+    bool isAddressed(KnxTelegram*);
+    bool processReceivedTelegram(bool interested);
+    bool processGroupObject(int filterIndex, KnxTelegram*);
+    void updateGroupObject(KnxTelegram*);
+    KnxTelegram* createKNXMessageFrame(int, KnxCommandType, byte* targetGroupAddress, int);
+    KnxTelegram* createKNXMessageFrameIndividual(int, KnxCommandType, byte* targetIndividualAddress, int);
+    bool sendMessage(KnxTelegram*);
+    bool sendNumbered(KnxTelegram*);
+    void sendTransport();
+    void writeFrame(KnxTelegramView frame);
+    int sendLeasedTelegram(KnxTelegram*, KnxTxCallback callback, void* context);
+    int queueTelegram(KnxTelegram*, KnxTxCallback callback, void* context, bool coalesce);
+    int enqueue(KnxTxSlot*, KnxTxCallback callback, void* context);
+    KnxTelegramView getTxView(KnxTxSlot*);
+    void sendHeldTelegrams();
+    void startTx();
+    void finishTx(bool success);
+
 
 };
 
@@ -0,0 +1,238 @@
+#include "KnxTransportConnection.h"
+
+static KnxIndividualAddress toIndividualAddress(uint16_t address) {
+    return KnxIndividualAddress(address >> 12, (address >> 8) & B1111, address & 0xFF);
+}
+
+KnxTransportConnection::KnxTransportConnection() {
+    clear();
+    _repetition_count = 0;
+    _duplicate_count = 0;
+}
+
+void KnxTransportConnection::clear() {
+    _state = KNX_TRANSPORT_CLOSED;
+    _remote = 0;
+    _send_sequence = 0;
+    _receive_sequence = 0;
+    _repetitions = 0;
+    _data_due = false;
+    _last_time = 0;
+    _ack_time = 0;
+    _control_first = 0;
+    _control_count = 0;
+}
+
+void KnxTransportConnection::connect(KnxIndividualAddress remote) {
+    disconnect();
+    open(remote.getValue());
+    queueControl(_remote, KNX_COMM_UCD, KNX_CONTROLDATA_CONNECT, 0);
+}
+
+void KnxTransportConnection::disconnect() {
+    if (_state != KNX_TRANSPORT_CLOSED) {
+        close();
+    }
+}
+
+bool KnxTransportConnection::send(KnxTelegram* telegram) {
+    if (_state != KNX_TRANSPORT_OPEN_IDLE) {
+        return false;
+    }
+
+    _data = *telegram;
+    _data.setTargetIndividualAddress(toIndividualAddress(_remote));
+    _data.setCommunicationType(KNX_COMM_NDP);
+    _data.setSequenceNumber(_send_sequence);
+    _state = KNX_TRANSPORT_OPEN_WAIT;
+    _repetitions = 0;
+    _data_due = true;
+    return true;
+}
+
+/*
+ * T_Connect opens the connection, or is turned down while another one is
+ * open. T_Data_Connected is acknowledged and delivered once per sequence
+ * number: a repetition of the last one is acknowledged again (our T_ACK
+ * was lost), others get T_NAK. T_ACK/T_NAK answer the telegram in flight.
+ */
+KnxTransportResult KnxTransportConnection::receive(KnxTelegram* telegram) {
+    uint16_t source = telegram->getSourceAddress().getValue();
+    bool partner = _state != KNX_TRANSPORT_CLOSED && source == _remote;
+    int sequence = telegram->getSequenceNumber();
+
+    switch (telegram->getCommunicationType()) {
+        case KNX_COMM_UCD:
+            if (telegram->getControlData() == KNX_CONTROLDATA_CONNECT) {
+                if (_state == KNX_TRANSPORT_CLOSED || partner) {
+                    // From the partner again: it starts over
+                    open(source);
+                } else {
+                    queueControl(source, KNX_COMM_UCD, KNX_CONTROLDATA_DISCONNECT, 0);
+                }
+            } else if (telegram->getControlData() == KNX_CONTROLDATA_DISCONNECT && partner) {
+                _state = KNX_TRANSPORT_CLOSED;
+                _data_due = false;
+            }
+            return KNX_TRANSPORT_HANDLED;
+
+        case KNX_COMM_NDP:
+            if (!partner) {
+                queueControl(source, KNX_COMM_UCD, KNX_CONTROLDATA_DISCONNECT, 0);
+                return KNX_TRANSPORT_HANDLED;
+            }
+            _last_time = millis();
+            if (sequence == _receive_sequence) {
+                queueControl(source, KNX_COMM_NCD, KNX_CONTROLDATA_POS_CONFIRM, sequence);
+                _receive_sequence = (_receive_sequence + 1) & B1111;
+                return KNX_TRANSPORT_DELIVER;
+            }
+            if (sequence == ((_receive_sequence - 1) & B1111)) {
+                queueControl(source, KNX_COMM_NCD, KNX_CONTROLDATA_POS_CONFIRM, sequence);
+                _duplicate_count++;
+            } else {
+                queueControl(source, KNX_COMM_NCD, KNX_CONTROLDATA_NEG_CONFIRM, sequence);
+            }
+            return KNX_TRANSPORT_HANDLED;
+
+        case KNX_COMM_NCD:
+            // A late T_ACK of a repeated telegram comes while idle, ignored
+            if (!partner || _state != KNX_TRANSPORT_OPEN_WAIT) {
+                return KNX_TRANSPORT_HANDLED;
+            }
+            _last_time = millis();
+            if (sequence != _send_sequence) {
+                // Out of step with the partner
+                close();
+            } else if (telegram->getControlData() == KNX_CONTROLDATA_POS_CONFIRM) {
+                _send_sequence = (_send_sequence + 1) & B1111;
+                _state = KNX_TRANSPORT_OPEN_IDLE;
+                _data_due = false;
+            } else {
+                repeat();
+            }
+            return KNX_TRANSPORT_HANDLED;
+
+        default:
+            return KNX_TRANSPORT_IGNORED;
+    }
+}
+
+void KnxTransportConnection::loop() {
+    if (_state == KNX_TRANSPORT_CLOSED) {
+        return;
+    }
+
+    unsigned long now = millis();
+    if (_state == KNX_TRANSPORT_OPEN_WAIT && !_data_due && now - _ack_time >= TPUART_TRANSPORT_ACK_TIMEOUT_MS) {
+        repeat();
+    }
+    if (_state != KNX_TRANSPORT_CLOSED && now - _last_time >= TPUART_TRANSPORT_CONNECTION_TIMEOUT_MS) {
+        close();
+    }
+}
+
+bool KnxTransportConnection::getControl(KnxTelegram* telegram) {
+    if (_control_count == 0) {
+        return false;
+    }
+
+    KnxTransportControl* control = &_control[_control_first];
+    telegram->clear();
+    telegram->setTargetIndividualAddress(toIndividualAddress(control->address));
+    telegram->setPayloadLength(1);
+    telegram->setCommunicationType((KnxCommunicationType) control->type);
+    telegram->setSequenceNumber(control->sequence);
+    telegram->setControlData((KnxControlDataType) control->control);
+    return true;
+}
+
+void KnxTransportConnection::controlSent() {
+    if (_control_count > 0) {
+        _control_first = (_control_first + 1) % TPUART_TRANSPORT_CONTROL_QUEUE_SIZE;
+        _control_count--;
+    }
+}
+
+KnxTelegram* KnxTransportConnection::getData() {
+    return _data_due ? &_data : 0;
+}
+
+void KnxTransportConnection::dataSent() {
+    _data_due = false;
+    _ack_time = millis();
+    _last_time = _ack_time;
+}
+
+KnxTransportState KnxTransportConnection::getState() {
+    return _state;
+}
+
+bool KnxTransportConnection::isOpen() {
+    return _state != KNX_TRANSPORT_CLOSED;
+}
+
+KnxIndividualAddress KnxTransportConnection::getRemoteAddress() {
+    return toIndividualAddress(_remote);
+}
+
+byte KnxTransportConnection::getSendSequence() {
+    return _send_sequence;
+}
+
+byte KnxTransportConnection::getReceiveSequence() {
+    return _receive_sequence;
+}
+
+unsigned long KnxTransportConnection::getRepetitionCount() {
+    return _repetition_count;
+}
+
+unsigned long KnxTransportConnection::getDuplicateCount() {
+    return _duplicate_count;
+}
+
+void KnxTransportConnection::open(uint16_t remote) {
+    _state = KNX_TRANSPORT_OPEN_IDLE;
+    _remote = remote;
+    _send_sequence = 0;
+    _receive_sequence = 0;
+    _data_due = false;
+    _last_time = millis();
+}
+
+/*
+ * Ends the connection with T_Disconnect to the partner
+ */
+void KnxTransportConnection::close() {
+    queueControl(_remote, KNX_COMM_UCD, KNX_CONTROLDATA_DISCONNECT, 0);
+    _state = KNX_TRANSPORT_CLOSED;
+    _data_due = false;
+}
+
+/*
+ * The telegram in flight once more, or the connection is given up
+ */
+void KnxTransportConnection::repeat() {
+    if (_repetitions >= TPUART_TRANSPORT_REPETITIONS) {
+        close();
+        return;
+    }
+    _repetitions++;
+    _repetition_count++;
+    _data_due = true;
+}
+
+void KnxTransportConnection::queueControl(uint16_t address, KnxCommunicationType type, KnxControlDataType control, int sequence) {
+    if (_control_count >= TPUART_TRANSPORT_CONTROL_QUEUE_SIZE) {
+        // Lost like on the bus: the partner repeats, or times out
+        return;
+    }
+
+    KnxTransportControl* entry = &_control[(_control_first + _control_count) % TPUART_TRANSPORT_CONTROL_QUEUE_SIZE];
+    entry->address = address;
+    entry->type = type;
+    entry->control = control;
+    entry->sequence = sequence;
+    _control_count++;
+}
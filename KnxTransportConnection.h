@@ -0,0 +1,125 @@
+#ifndef KnxTransportConnection_h
+#define KnxTransportConnection_h
+
+#include "Arduino.h"
+
+#include "KnxTelegram.h"
+
+// Time to wait for the T_ACK of a T_Data_Connected before it is repeated
+#ifndef TPUART_TRANSPORT_ACK_TIMEOUT_MS
+#define TPUART_TRANSPORT_ACK_TIMEOUT_MS 3000
+#endif
+
+// A connection without telegrams for this long is closed
+#ifndef TPUART_TRANSPORT_CONNECTION_TIMEOUT_MS
+#define TPUART_TRANSPORT_CONNECTION_TIMEOUT_MS 6000
+#endif
+
+// Repetitions of a T_Data_Connected after T_NAK or timeout, then the
+// connection is closed
+#ifndef TPUART_TRANSPORT_REPETITIONS
+#define TPUART_TRANSPORT_REPETITIONS 3
+#endif
+
+// Control telegrams (T_ACK, T_NAK, T_Connect, T_Disconnect) waiting for
+// room in the transmit queue, later ones are dropped
+#ifndef TPUART_TRANSPORT_CONTROL_QUEUE_SIZE
+#define TPUART_TRANSPORT_CONTROL_QUEUE_SIZE 4
+#endif
+
+#if TPUART_TRANSPORT_CONTROL_QUEUE_SIZE > 255
+#error "TPUART_TRANSPORT_CONTROL_QUEUE_SIZE must be at most 255"
+#endif
+
+enum KnxTransportState {
+    KNX_TRANSPORT_CLOSED,
+    KNX_TRANSPORT_OPEN_IDLE,
+    KNX_TRANSPORT_OPEN_WAIT     // T_Data_Connected sent, waiting for its T_ACK
+};
+
+// What became of a received point-to-point telegram
+enum KnxTransportResult {
+    KNX_TRANSPORT_IGNORED,      // connectionless, not for the transport layer
+    KNX_TRANSPORT_DELIVER,      // T_Data_Connected in sequence, for the application
+    KNX_TRANSPORT_HANDLED       // control telegram, duplicate or not in sequence
+};
+
+// A control telegram waiting to be sent
+struct KnxTransportControl {
+    uint16_t address;
+    byte type;          // KnxCommunicationType, UCD or NCD
+    byte control;       // KnxControlDataType
+    byte sequence;      // of the acknowledged T_Data_Connected
+};
+
+/*
+ * Connection-oriented transport layer for one connection at a time, as
+ * server (the remote device connects) or client (connect()). Sequence
+ * numbers of both directions, one T_Data_Connected in flight, which is
+ * repeated after T_NAK or TPUART_TRANSPORT_ACK_TIMEOUT_MS. Received
+ * duplicates are acknowledged again but not delivered.
+ *
+ * Never sends itself: the telegrams to send are taken by the owner, see
+ * getControl() and getData(), e.g. KnxTpUart from loop() and after
+ * receiving.
+ */
+class KnxTransportConnection {
+    public:
+        KnxTransportConnection();
+
+        // Closed, nothing pending
+        void clear();
+
+        // Opens a connection to remote, replacing the current one
+        void connect(KnxIndividualAddress remote);
+        void disconnect();
+        // T_Data_Connected with the APDU of telegram. False while closed or
+        // while the last one waits for its T_ACK.
+        bool send(KnxTelegram* telegram);
+
+        // Telegram from source to our individual address
+        KnxTransportResult receive(KnxTelegram* telegram);
+        // Timeouts
+        void loop();
+
+        // Next control telegram to send, false if there is none. It is
+        // removed with controlSent() once it was queued.
+        bool getControl(KnxTelegram* telegram);
+        void controlSent();
+        // T_Data_Connected to send or to repeat, 0 if there is none. Sent
+        // with dataSent() once it was queued, which starts the T_ACK timeout.
+        KnxTelegram* getData();
+        void dataSent();
+
+        KnxTransportState getState();
+        bool isOpen();
+        KnxIndividualAddress getRemoteAddress();
+        byte getSendSequence();
+        byte getReceiveSequence();
+        // Counters: T_Data_Connected repeated, and received again
+        unsigned long getRepetitionCount();
+        unsigned long getDuplicateCount();
+
+    private:
+        KnxTransportState _state;
+        uint16_t _remote;
+        byte _send_sequence;
+        byte _receive_sequence;
+        byte _repetitions;          // of the telegram waiting for its T_ACK
+        bool _data_due;
+        unsigned long _last_time;   // millis() of the last telegram on the connection
+        unsigned long _ack_time;    // millis() the data telegram was queued
+        KnxTelegram _data;
+        KnxTransportControl _control[TPUART_TRANSPORT_CONTROL_QUEUE_SIZE];
+        byte _control_first;
+        byte _control_count;
+        unsigned long _repetition_count;
+        unsigned long _duplicate_count;
+
+        void open(uint16_t remote);
+        void close();
+        void repeat();
+        void queueControl(uint16_t address, KnxCommunicationType type, KnxControlDataType control, int sequence);
+};
+
+#endif
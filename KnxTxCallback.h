@@ -0,0 +1,8 @@
+#ifndef KnxTxCallback_h
+#define KnxTxCallback_h
+
+// Called when a queued telegram was confirmed by the TPUART (success = true)
+// or was rejected / not confirmed in time (success = false)
+typedef void (*KnxTxCallback)(int handle, bool success, void* context);
+
+#endif
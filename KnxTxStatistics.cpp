@@ -0,0 +1,87 @@
+#include "KnxTxStatistics.h"
+
+static void increment(uint16_t* counter) {
+    if (*counter < 0xFFFF) {
+        (*counter)++;
+    }
+}
+
+KnxTxStatisticsTable::KnxTxStatisticsTable() {
+    clear();
+}
+
+void KnxTxStatisticsTable::clear() {
+    _count = 0;
+    _total.groupAddress = 0;
+    _total.confirmed = 0;
+    _total.failed = 0;
+    _total.retries = 0;
+}
+
+void KnxTxStatisticsTable::addConfirmed(KnxTelegramView telegram) {
+    KnxTxStatistics* entry = findOrAdd(telegram);
+    if (entry != 0) {
+        increment(&entry->confirmed);
+    }
+    increment(&_total.confirmed);
+}
+
+void KnxTxStatisticsTable::addFailed(KnxTelegramView telegram) {
+    KnxTxStatistics* entry = findOrAdd(telegram);
+    if (entry != 0) {
+        increment(&entry->failed);
+    }
+    increment(&_total.failed);
+}
+
+void KnxTxStatisticsTable::addRetry(KnxTelegramView telegram) {
+    KnxTxStatistics* entry = findOrAdd(telegram);
+    if (entry != 0) {
+        increment(&entry->retries);
+    }
+    increment(&_total.retries);
+}
+
+const KnxTxStatistics* KnxTxStatisticsTable::find(KnxGroupAddress groupAddress) {
+    return lookup(groupAddress.getValue());
+}
+
+int KnxTxStatisticsTable::getCount() {
+    return _count;
+}
+
+const KnxTxStatistics* KnxTxStatisticsTable::get(int index) {
+    return &_entries[index];
+}
+
+const KnxTxStatistics* KnxTxStatisticsTable::getTotal() {
+    return &_total;
+}
+
+KnxTxStatistics* KnxTxStatisticsTable::findOrAdd(KnxTelegramView telegram) {
+    if (!telegram.isTargetGroup()) {
+        return 0;
+    }
+
+    uint16_t groupAddress = telegram.getTargetGroupAddress().getValue();
+    KnxTxStatistics* entry = lookup(groupAddress);
+    if (entry != 0 || _count >= MAX_TX_STATISTICS) {
+        return entry;
+    }
+
+    entry = &_entries[_count++];
+    entry->groupAddress = groupAddress;
+    entry->confirmed = 0;
+    entry->failed = 0;
+    entry->retries = 0;
+    return entry;
+}
+
+KnxTxStatistics* KnxTxStatisticsTable::lookup(uint16_t groupAddress) {
+    for (int i = 0; i < _count; i++) {
+        if (_entries[i].groupAddress == groupAddress) {
+            return &_entries[i];
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,55 @@
+#ifndef KnxTxStatistics_h
+#define KnxTxStatistics_h
+
+#include "Arduino.h"
+
+#include "KnxTelegram.h"
+
+// Number of group addresses counted separately, later ones only in the totals
+#ifndef MAX_TX_STATISTICS
+#define MAX_TX_STATISTICS 16
+#endif
+
+#if MAX_TX_STATISTICS > 255
+#error "MAX_TX_STATISTICS must be at most 255"
+#endif
+
+// Delivery of the telegrams sent to one group address, counters saturate
+struct KnxTxStatistics {
+    uint16_t groupAddress;
+    uint16_t confirmed;     // confirmed by the TPUART, after retries or not
+    uint16_t failed;        // given up after the last attempt
+    uint16_t retries;       // attempts after the first
+};
+
+/*
+ * Counters by group address, in the order the addresses were first sent to
+ */
+class KnxTxStatisticsTable {
+    public:
+        KnxTxStatisticsTable();
+
+        void clear();
+
+        // Telegram as it was sent, counted by its target group address
+        void addConfirmed(KnxTelegramView telegram);
+        void addFailed(KnxTelegramView telegram);
+        void addRetry(KnxTelegramView telegram);
+
+        // 0 if nothing was sent to the address or it did not fit
+        const KnxTxStatistics* find(KnxGroupAddress groupAddress);
+        int getCount();
+        const KnxTxStatistics* get(int index);
+        // All telegrams, group addresses or not
+        const KnxTxStatistics* getTotal();
+
+    private:
+        KnxTxStatistics _entries[MAX_TX_STATISTICS];
+        KnxTxStatistics _total;
+        byte _count;
+
+        KnxTxStatistics* findOrAdd(KnxTelegramView telegram);
+        KnxTxStatistics* lookup(uint16_t groupAddress);
+};
+
+#endif
@@ -0,0 +1,68 @@
+// Microbenchmarks of the telegram encode/decode and dispatch hot paths
+// Counts CPU cycles per operation with Timer1 (AVR, prescaler 1)
+// Results are printed to Serial, the TPUART is not needed
+
+#include <KnxTpUart.h>
+#include "KnxBenchmarks.h"
+
+#define ITERATIONS 200
+
+volatile unsigned long timer1Overflows = 0;
+
+ISR(TIMER1_OVF_vect) {
+  timer1Overflows++;
+}
+
+unsigned long cycles() {
+  noInterrupts();
+  unsigned long overflows = timer1Overflows;
+  unsigned int count = TCNT1;
+  if ((TIFR1 & _BV(TOV1)) && count < 0x8000) {
+    // Overflow happened after interrupts were disabled
+    overflows++;
+  }
+  interrupts();
+  return (overflows << 16) | count;
+}
+
+void setup() {
+  Serial.begin(115200);
+  knxBenchSetup();
+
+  // Timer1 free running at CPU clock
+  TCCR1A = 0;
+  TCCR1B = _BV(CS10);
+  TIMSK1 = _BV(TOIE1);
+}
+
+void loop() {
+  // Cost of the measurement itself
+  unsigned long start = cycles();
+  for (int i = 0; i < ITERATIONS; i++) {
+    knxBenchSink = i;
+  }
+  unsigned long overhead = cycles() - start;
+
+  for (unsigned int b = 0; b < KNX_BENCHMARK_COUNT; b++) {
+    knxBenchFailures = 0;
+    start = cycles();
+    for (int i = 0; i < ITERATIONS; i++) {
+      knxBenchmarks[b].run();
+    }
+    unsigned long elapsed = cycles() - start - overhead;
+
+    Serial.print(knxBenchmarks[b].name);
+    Serial.print(": ");
+    Serial.print(elapsed / ITERATIONS);
+    Serial.print(" cycles/op");
+    if (knxBenchFailures > 0) {
+      Serial.print(", ");
+      Serial.print(knxBenchFailures);
+      Serial.print(" failed");
+    }
+    Serial.println();
+  }
+
+  Serial.println();
+  delay(5000);
+}
@@ -0,0 +1,225 @@
+#ifndef KnxBenchmarks_h
+#define KnxBenchmarks_h
+
+/*
+ * Microbenchmarks for the per-frame hot paths, shared by the AVR sketch
+ * (Benchmark.ino, cycles from Timer1) and the host runner
+ * (extras/host/bench/KnxBench.cpp, ns/op and allocations).
+ *
+ * Each benchmark runs one operation per call on the fixed corpus below,
+ * cycling through the telegrams, so results are comparable between runs.
+ * Include from one translation unit only.
+ */
+
+#include <KnxTpUart.h>
+
+/*
+ * Corpus: telegrams as seen on a typical line, checksums included
+ */
+static const byte knxBenchSwitch[] = {       // 1.1.20 -> 1/1/1 write DPT 1 on
+    0xBC, 0x11, 0x14, 0x09, 0x01, 0xE1, 0x00, 0x81, 0x2E };
+static const byte knxBenchTemperature[] = {  // 1.1.21 -> 3/2/10 write DPT 9 21.5
+    0xBC, 0x11, 0x15, 0x1A, 0x0A, 0xE3, 0x00, 0x80, 0x0C, 0x33, 0x0B };
+static const byte knxBenchDimmer[] = {       // 1.1.22 -> 1/4/7 write DPT 5.001 50%
+    0xBC, 0x11, 0x16, 0x0C, 0x07, 0xE2, 0x00, 0x80, 0x80, 0xAD };
+static const byte knxBenchRead[] = {         // 1.1.250 -> 3/2/10 read
+    0xBC, 0x11, 0xFA, 0x1A, 0x0A, 0xE1, 0x00, 0x00, 0x59 };
+static const byte knxBenchAnswer[] = {       // 1.1.21 -> 3/2/10 answer DPT 9 21.5
+    0xBC, 0x11, 0x15, 0x1A, 0x0A, 0xE3, 0x00, 0x40, 0x0C, 0x33, 0xCB };
+static const byte knxBenchPower[] = {        // 1.1.30 -> 4/0/1 write DPT 14 1234.5
+    0xBC, 0x11, 0x1E, 0x20, 0x01, 0xE5, 0x00, 0x80, 0x44, 0x9A, 0x50, 0x00, 0x86 };
+static const byte knxBenchText[] = {         // 1.1.31 -> 5/0/1 write DPT 16 "Kitchen window"
+    0xBC, 0x11, 0x1F, 0x28, 0x01, 0xEF, 0x00, 0x80, 0x4B, 0x69, 0x74, 0x63,
+    0x68, 0x65, 0x6E, 0x20, 0x77, 0x69, 0x6E, 0x64, 0x6F, 0x77, 0x71 };
+static const byte knxBenchTime[] = {         // 1.1.1 -> 0/0/1 write DPT 10 wed 12:30:15
+    0xBC, 0x11, 0x01, 0x00, 0x01, 0xE4, 0x00, 0x80, 0x6C, 0x1E, 0x0F, 0x4B };
+static const byte knxBenchRepeated[] = {     // repetition of a switch telegram, off
+    0x9C, 0x11, 0x14, 0x09, 0x01, 0xE1, 0x00, 0x80, 0x0F };
+static const byte knxBenchNcdAck[] = {       // 1.1.250 -> 1.1.10 T_ACK sequence 3
+    0xBC, 0x11, 0xFA, 0x11, 0x0A, 0x60, 0xCE, 0x1D };
+
+struct KnxBenchFrame {
+    const byte* data;
+    byte length;
+};
+
+#define KNX_BENCH_FRAME(frame) { frame, sizeof(frame) }
+
+static const KnxBenchFrame knxBenchCorpus[] = {
+    KNX_BENCH_FRAME(knxBenchSwitch),
+    KNX_BENCH_FRAME(knxBenchTemperature),
+    KNX_BENCH_FRAME(knxBenchDimmer),
+    KNX_BENCH_FRAME(knxBenchRead),
+    KNX_BENCH_FRAME(knxBenchAnswer),
+    KNX_BENCH_FRAME(knxBenchPower),
+    KNX_BENCH_FRAME(knxBenchText),
+    KNX_BENCH_FRAME(knxBenchTime),
+    KNX_BENCH_FRAME(knxBenchRepeated),
+    KNX_BENCH_FRAME(knxBenchNcdAck)
+};
+
+#define KNX_BENCH_CORPUS_SIZE (sizeof(knxBenchCorpus) / sizeof(knxBenchCorpus[0]))
+
+/*
+ * Serial port replaying corpus frames, written bytes are discarded
+ */
+class KnxBenchStream : public Stream {
+    public:
+        KnxBenchStream() : _data(0), _length(0), _pos(0) {}
+
+        void feed(const byte* data, int length) {
+            _data = data;
+            _length = length;
+            _pos = 0;
+        }
+
+        int available() { return _length - _pos; }
+        int read() { return _pos < _length ? _data[_pos++] : -1; }
+        int peek() { return _pos < _length ? _data[_pos] : -1; }
+        size_t write(uint8_t) { return 1; }
+        size_t write(const uint8_t*, size_t size) { return size; }
+
+    private:
+        const byte* _data;
+        int _length;
+        int _pos;
+};
+
+static KnxBenchStream knxBenchStream;
+static KnxTpUart knxBenchTpUart(&knxBenchStream, "1.1.10"_pa);
+static KnxTelegram knxBenchTelegram;
+static unsigned int knxBenchIndex;
+static volatile int knxBenchSink;    // keeps results from being optimized away
+static unsigned long knxBenchFailures;  // operations that didn't do what they measure
+
+static const byte knxBenchConfirm = TPUART_DATA_CONFIRM_SUCCESS;
+
+static const KnxBenchFrame& knxBenchNextFrame() {
+    knxBenchIndex = (knxBenchIndex + 1) % KNX_BENCH_CORPUS_SIZE;
+    return knxBenchCorpus[knxBenchIndex];
+}
+
+/*
+ * Listens to a full filter of group addresses, including the group
+ * addresses of the corpus. Sending may take the whole bus.
+ */
+static void knxBenchSetup() {
+    knxBenchTpUart.setTxBudget(KNX_PRIORITY_NORMAL, 100);
+    knxBenchTpUart.setBusLoadLimit(100);
+    knxBenchTpUart.addListenGroupAddress("1/1/1"_ga);
+    knxBenchTpUart.addListenGroupAddress("3/2/10"_ga);
+    knxBenchTpUart.addListenGroupAddress("1/4/7"_ga);
+    for (int i = 3; i < MAX_LISTEN_GROUP_ADDRESSES; i++) {
+        knxBenchTpUart.addListenGroupAddress(KnxGroupAddress(2, i % 8, i));
+    }
+    knxBenchTelegram.setSourceAddress("1.1.10"_pa);
+    knxBenchTelegram.setTargetGroupAddress("3/2/10"_ga);
+    knxBenchTelegram.set2ByteFloatValue(21.5);
+}
+
+static void knxBenchChecksum() {
+    const KnxBenchFrame& frame = knxBenchNextFrame();
+    knxBenchSink = KnxTelegramView(frame.data, frame.length).calculateChecksum();
+}
+
+static void knxBenchVerifyChecksum() {
+    const KnxBenchFrame& frame = knxBenchNextFrame();
+    knxBenchSink = KnxTelegramView(frame.data, frame.length).verifyChecksum();
+}
+
+static void knxBenchSet2ByteFloat() {
+    knxBenchTelegram.set2ByteFloatValue((int) (knxBenchIndex++ % 2000) - 1000 + 0.25);
+}
+
+static void knxBenchGet2ByteFloat() {
+    knxBenchSink = knxBenchTelegram.get2ByteFloatValue();
+}
+
+static void knxBenchSet1ByteInt() {
+    knxBenchTelegram.set1ByteIntValue(knxBenchIndex++ & 0xFF);
+}
+
+static void knxBenchSet4ByteFloat() {
+    knxBenchTelegram.set4ByteFloatValue(knxBenchIndex++ * 0.5);
+}
+
+static void knxBenchGetValueView() {
+    const KnxBenchFrame& frame = knxBenchNextFrame();
+    knxBenchSink = KnxTelegramView(frame.data, frame.length).getValue<Dpt<9> >();
+}
+
+static void knxBenchListening() {
+    const KnxBenchFrame& frame = knxBenchNextFrame();
+    knxBenchSink = knxBenchTpUart.isListeningToGroupAddress((byte*) &frame.data[3]);
+}
+
+/*
+ * Same steps as KnxTpUart::createKNXMessageFrame() followed by a value
+ */
+static void knxBenchCreateFrame() {
+    knxBenchTelegram.clear();
+    knxBenchTelegram.setSourceAddress("1.1.10"_pa);
+    knxBenchTelegram.setTargetGroupAddress("3/2/10"_ga);
+    knxBenchTelegram.setFirstDataByte(0);
+    knxBenchTelegram.setCommand(KNX_COMMAND_WRITE);
+    knxBenchTelegram.setPayloadLength(4);
+    knxBenchTelegram.set2ByteFloatValue(21.5);
+    knxBenchTelegram.createChecksum();
+}
+
+// Twice the bus time of the DPT 9 frame of knxBenchGroupWrite() and its
+// acknowledge: the writes take half of the bus
+#define KNX_BENCH_WRITE_MICROS KNX_BUS_BITS_TO_MICROS(2 * (KNX_BUS_IDLE_BITS + 11 * KNX_BUS_CHAR_BITS + KNX_BUS_ACK_GAP_BITS + KNX_BUS_CHAR_BITS))
+
+/*
+ * groupWrite through the transmit queue, completed by L_DATA.con. On the
+ * host KNX_BENCH_WRITE_MICROS pass on the virtual clock, so the writes stay
+ * within the sending budget. On the AVR a round writes faster than the bus
+ * carries, the writes beyond the budget are refused. Refused writes count as
+ * failures.
+ */
+static void knxBenchGroupWrite() {
+    if (!knxBenchTpUart.groupWrite2ByteFloat("3/2/10"_ga, 21.5)) {
+        knxBenchFailures++;
+    }
+    knxBenchStream.feed(&knxBenchConfirm, 1);
+    knxBenchSink = knxBenchTpUart.serialEvent();
+#if !defined(__AVR__)
+    hostAdvanceMicros(KNX_BENCH_WRITE_MICROS);
+#endif
+}
+
+/*
+ * One corpus frame through serialEvent() and the receive state machine,
+ * including the acknowledge decision
+ */
+static void knxBenchReceive() {
+    const KnxBenchFrame& frame = knxBenchNextFrame();
+    knxBenchStream.feed(frame.data, frame.length);
+    knxBenchSink = knxBenchTpUart.serialEvent();
+}
+
+typedef void (*KnxBenchFunction)();
+
+struct KnxBenchmark {
+    const char* name;
+    KnxBenchFunction run;
+};
+
+static const KnxBenchmark knxBenchmarks[] = {
+    { "calculateChecksum", knxBenchChecksum },
+    { "verifyChecksum", knxBenchVerifyChecksum },
+    { "set2ByteFloatValue", knxBenchSet2ByteFloat },
+    { "get2ByteFloatValue", knxBenchGet2ByteFloat },
+    { "set1ByteIntValue", knxBenchSet1ByteInt },
+    { "set4ByteFloatValue", knxBenchSet4ByteFloat },
+    { "view getValue<Dpt<9> >", knxBenchGetValueView },
+    { "isListeningToGroupAddress", knxBenchListening },
+    { "createKNXMessageFrame", knxBenchCreateFrame },
+    { "groupWrite2ByteFloat", knxBenchGroupWrite },
+    { "serialEvent receive", knxBenchReceive }
+};
+
+#define KNX_BENCHMARK_COUNT (sizeof(knxBenchmarks) / sizeof(knxBenchmarks[0]))
+
+#endif
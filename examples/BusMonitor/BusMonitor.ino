@@ -0,0 +1,52 @@
+#include <KnxTpUart.h>
+
+// Line-wide sniffer: every frame and acknowledge on the bus, nothing is sent
+// KNX TP-UART on the Serial1 port of Arduino Mega
+KnxTpUart knx(&Serial1, "15.15.20"_pa);
+KnxMonitorBuffer monitor;
+
+void setup() {
+  Serial.begin(115200);
+  Serial.println("TP-UART bus monitor");
+
+  Serial1.begin(19200);
+  UCSR1C = UCSR1C | B00100000; // Even Parity
+
+  knx.uartReset();
+  knx.setMonitorMode(&monitor);
+}
+
+void loop() {
+  // Print the frames collected meanwhile
+  const KnxMonitorFrame* frames;
+  int count;
+  while ((count = monitor.peek(&frames)) > 0) {
+    for (int i = 0; i < count; i++) {
+      printFrame(&frames[i]);
+    }
+    monitor.release(count);
+  }
+}
+
+void printFrame(const KnxMonitorFrame* frame) {
+  Serial.print(frame->time);
+  if (frame->flags & KNX_MONITOR_OVERFLOW) {
+    Serial.print(" (frames lost)");
+  }
+  if (frame->flags & KNX_MONITOR_ACK) {
+    Serial.print(frame->data[0] == KNX_BUS_ACK ? " ACK" : (frame->data[0] == KNX_BUS_NACK ? " NACK" : " BUSY"));
+  } else {
+    Serial.print(frame->flags & KNX_MONITOR_CHECKSUM_ERROR ? " checksum error" : "");
+    Serial.print(frame->flags & KNX_MONITOR_TRUNCATED ? " truncated" : "");
+    Serial.print(frame->flags & KNX_MONITOR_PARTIAL ? " partial" : "");
+    for (int i = 0; i < frame->length; i++) {
+      Serial.print(" ");
+      Serial.print(frame->data[i], HEX);
+    }
+  }
+  Serial.println();
+}
+
+void serialEvent1() {
+  knx.serialEvent();
+}
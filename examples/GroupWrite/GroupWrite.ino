@@ -1,8 +1,10 @@
 #include <KnxTpUart.h>
 
 // Initialize the KNX TP-UART library on the Serial1 port of Arduino 
-//KnxTpUart knx(&Serial1, PA_STRING("15.15.20"));
-KnxTpUart knx(&Serial1, PA_INTEGER(15,15,20));
+KnxTpUart knx(&Serial1, "15.15.20"_pa);
+
+// Define group address to send to, constexpr: parsed at compile time
+constexpr KnxGroupAddress SWITCH_GROUP = "0/0/3"_ga;
 
 // Define input pin
 int inPin = 32;
@@ -43,16 +45,18 @@ void setup() {
 
 
 void loop() {
+   // Handle confirmation timeouts of queued telegrams
+   knx.loop();
+
    if (digitalRead(inPin) == LOW) {
        // Button is pressed
        digitalWrite(13, HIGH);
        
        if (!haveSent) {
            // Send the opposite of what we have sent last
-           //bool success = knx.groupWriteBool(GA_STRING("0/0/3"), !onSent);
-           bool success = knx.groupWriteBool(GA_INTEGER(0,0,3), !onSent);
+           bool success = knx.groupWriteBool(SWITCH_GROUP, !onSent);
            
-           Serial.print("Successfully sent: ");
+           Serial.print("Successfully queued: ");
            Serial.println(success);
            
            onSent = !onSent;
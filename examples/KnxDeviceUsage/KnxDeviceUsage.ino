@@ -9,7 +9,7 @@
 
 
 // Start with default PA
-KnxTpUart knx(&Serial1, PA_INTEGER(15,15,20));
+KnxTpUart knx(&Serial1, "15.15.20"_pa);
 KnxDevice knxDevice(&knx);
 
 
@@ -1,7 +1,7 @@
 #include <KnxTpUart.h>
 
 // Initialize the KNX TP-UART library on the Serial1 port of Arduino Mega
-KnxTpUart knx(&Serial1, 15, 15, 20);
+KnxTpUart knx(&Serial1, KnxIndividualAddress(15, 15, 20));
 
 // Start in programming mode
 boolean programmingMode = true;
@@ -18,6 +18,8 @@ void setup() {
 
 
 void loop() {
+  // Handle confirmation timeouts of queued telegrams
+  knx.loop();
 }
 
 void serialEvent1() {
@@ -39,7 +41,7 @@ void serialEvent1() {
       Serial.print(".");
       Serial.println(member);   
 
-      knx.setIndividualAddress(area, line, member);    
+      knx.setIndividualAddress(KnxIndividualAddress(area, line, member));    
    
       // Here the new address could be stored to EEPROM and be reloaded after restart of Arduino   
     } else if (telegram->getCommand() == KNX_COMMAND_MASK_VERSION_READ) {
@@ -2,7 +2,7 @@
 
 // Initialize the KNX TP-UART library on the Serial1 port of Arduino Mega
 // and with KNX physical address 15.15.20
-KnxTpUart knx(&Serial1, "15.15.20");
+KnxTpUart knx(&Serial1, "15.15.20"_pa);
 
 void setup() {
   Serial.begin(9600);
@@ -1,10 +1,10 @@
 #include <KnxTpUart.h>
 
-// Define group address to react on
-String my_address = "0/0/100";
+// Define group address to react on, constexpr: parsed at compile time
+constexpr KnxGroupAddress my_address = "0/0/100"_ga;
 
 // Initialize the KNX TP-UART library on the Serial1 port of Arduino Mega
-KnxTpUart knx(&Serial1, "15.15.20");
+KnxTpUart knx(&Serial1, "15.15.20"_pa);
 
 void setup() {
   Serial.begin(9600);
@@ -23,29 +23,22 @@ void setup() {
   Serial.println(UCSR1C, BIN);
 
   knx.uartReset();
-  knx.addListenGroupAddress(my_address);
+  // Listen to my_address and answer read requests to it
+  knx.addGroupHandler(my_address, KNX_COMMAND_READ, onRead);
+}
+
+// Called from serialEvent() for read requests to my_address
+void onRead(KnxTelegram* telegram, void* context) {
+  //knx.groupAnswerBool(my_address, true);
+  knx.groupAnswer2ByteFloat(my_address, 25.28);
 }
 
 
 void loop() {
+  // Handle confirmation timeouts of queued telegrams
+  knx.loop();
 }
 
 void serialEvent1() {
-  KnxTpUartSerialEventType eType = knx.serialEvent();
-  if (eType == KNX_TELEGRAM) {
-     KnxTelegram* telegram = knx.getReceivedTelegram();
-
-     // Is it a read request?
-     if (telegram->getCommand() == KNX_COMMAND_READ) {
-        //knx.groupAnswerBool(my_address, true);
-        knx.groupAnswer2ByteFloat(my_address, 25.28);
-     }   
-  }
+  knx.serialEvent();
 }
-
-
-
-
-
-
-
@@ -11,17 +11,15 @@ DallasTemperature sensors(&oneWire);
 #define SEND_INTERVAL_MS 5000
 
 // Initialize the KNX TP-UART library on the Serial1 port of Arduino Mega
-KnxTpUart knx(&Serial1, "15.15.20");
+KnxTpUart knx(&Serial1, "15.15.20"_pa);
+
+// Define group address to send temperature to, read requests to it are
+// answered with the last value sent. constexpr: parsed at compile time
+constexpr KnxGroupAddress WRITE_GROUP = "0/0/101"_ga;
 
 unsigned long startTime;
 
 void setup() {
-  // Define group address to react on (for read requests)
-  String READ_GROUP = "0/0/100";
-
-  // Define group address to send temperature to
-  String WRITE_GROUP = "0/0/101";
-
   Serial.begin(9600);
   Serial.println("TP-UART Test");  
 
@@ -38,13 +36,16 @@ void setup() {
   Serial.println(UCSR1C, BIN);
 
   knx.uartReset();
-  knx.addListenGroupAddress(READ_GROUP);
+  knx.addGroupObject(WRITE_GROUP);
   
   startTime = millis();
 }
 
 
 void loop() {
+  // Handle confirmation timeouts of queued telegrams
+  knx.loop();
+
   if (abs(millis() - startTime) < SEND_INTERVAL_MS) {
     delay(1);
     return;
@@ -55,20 +56,13 @@ void loop() {
   Serial.print("Sending temp: ");
   Serial.println(temp);  
   bool result = knx.groupWrite2ByteFloat(WRITE_GROUP, temp);
-  Serial.print("Sent successfully: ");
+  Serial.print("Queued successfully: ");
   Serial.println(result);
 }
 
 void serialEvent1() {
-  KnxTpUartSerialEventType eType = knx.serialEvent();
-  if (eType == KNX_TELEGRAM) {
-     KnxTelegram* telegram = knx.getReceivedTelegram();
-
-     // Is it a read request?
-     if (telegram->getCommand() == KNX_COMMAND_READ) {
-        knx.groupAnswer2ByteFloat(READ_GROUP, getTemp());
-     }   
-  }
+  // Read requests are answered inside
+  knx.serialEvent();
 }
 
 float getTemp() {
@@ -2,7 +2,7 @@
 #include <ArduinoUnit.h>
 
 TestSuite suite;
-KnxTpUart knx(&Serial1, "15.15.20");
+KnxTpUart knx(&Serial1, "15.15.20"_pa);
 KnxTelegram* knxTelegram = new KnxTelegram();
 
 void setup() {
@@ -59,14 +59,14 @@ test(priorityProperty) {
 }
 
 test(sourceAddressProperties) {
-  knxTelegram->setSourceAddress(15, 12, 20);
+  knxTelegram->setSourceAddress(KnxIndividualAddress(15, 12, 20));
   assertEquals(15, knxTelegram->getSourceArea());
   assertEquals(12, knxTelegram->getSourceLine());
   assertEquals(20, knxTelegram->getSourceMember()); 
 }
 
 test(targetAddressProperties) {
-  knxTelegram->setTargetGroupAddress(0, 3, 15);
+  knxTelegram->setTargetGroupAddress(KnxGroupAddress(0, 3, 15));
   assertTrue(knxTelegram->isTargetGroup());
   assertEquals(0, knxTelegram->getTargetMainGroup());
   assertEquals(3, knxTelegram->getTargetMiddleGroup());
@@ -104,10 +104,82 @@ test(checksumProperty) {
   assertTrue(knxTelegram->verifyChecksum()); 
 }
 
+test(telegramView) {
+  knxTelegram->clear();
+  knxTelegram->setTargetGroupAddress(GA_INTEGER(1, 2, 3));
+  knxTelegram->setCommand(KNX_COMMAND_WRITE);
+  knxTelegram->set2ByteFloatValue(21.5);
+  knxTelegram->createChecksum();
+
+  // View on a copy of the raw bytes, e.g. from a capture
+  byte raw[MAX_KNX_TELEGRAM_SIZE];
+  for (int i = 0; i < knxTelegram->getTotalLength(); i++) {
+    raw[i] = knxTelegram->getBufferByte(i);
+  }
+  KnxTelegramView view(raw, knxTelegram->getTotalLength());
+
+  assertTrue(view.isComplete());
+  assertTrue(view.verifyChecksum());
+  assertEquals(KNX_COMMAND_WRITE, view.getCommand());
+  assertEquals(1, view.getTargetMainGroup());
+  assertEquals(2, view.getTargetMiddleGroup());
+  assertEquals(3, view.getTargetSubGroup());
+  assertEquals(knxTelegram->get2ByteFloatValue(), view.get2ByteFloatValue());
+
+  KnxTelegramView truncated(raw, 5);
+  assertTrue(! truncated.isComplete());
+}
+
+test(preparedTelegram) {
+  KnxPreparedTelegram prepared;
+  prepared.prepare(PA_INTEGER(15, 15, 20), GA_INTEGER(0, 0, 101), KNX_COMMAND_WRITE, 4);
+  assertTrue(prepared.getTelegram()->verifyChecksum());
+
+  prepared.set2ByteFloatValue(21.5);
+  assertTrue(prepared.getTelegram()->verifyChecksum());
+  assertEquals(2150, prepared.getTelegram()->get2ByteFloatValue() * 100);
+
+  prepared.set2ByteFloatValue(-3.2);
+  assertTrue(prepared.getTelegram()->verifyChecksum());
+
+  // Other payload lengths are refused, the checksum is never overwritten
+  assertTrue(! prepared.setBool(true));
+  assertTrue(! prepared.setDataByte(prepared.getTelegram()->getTotalLength() - 1, 0));
+  assertTrue(prepared.getTelegram()->verifyChecksum());
+
+  prepared.prepare<Dpt<1> >("15.15.20"_pa, "0/0/101"_ga, KNX_COMMAND_WRITE);
+  assertTrue(! prepared.set2ByteFloatValue(21.5));
+  assertTrue(prepared.setBool(true));
+  assertTrue(prepared.getTelegram()->verifyChecksum());
+  assertTrue(prepared.getTelegram()->getBool());
+}
+
 test(receivingGroupAddresses) {
-  knx.addListenGroupAddress("15/15/100");
-  assertTrue(knx.isListeningToGroupAddress(15, 15, 100));
-  assertTrue(! knx.isListeningToGroupAddress(15, 3, 28)); 
+  knx.addListenGroupAddress("15/15/100"_ga);
+  assertTrue(knx.isListeningToGroupAddress(KnxGroupAddress(15, 15, 100)));
+  assertTrue(! knx.isListeningToGroupAddress(KnxGroupAddress(15, 3, 28))); 
+}
+
+test(addressLiterals) {
+  // Parsed at compile time
+  static_assert("1/2/3"_ga == KnxGroupAddress(1, 2, 3), "group address literal");
+  static_assert("1.1.20"_pa == KnxIndividualAddress(1, 1, 20), "individual address literal");
+
+  KnxGroupAddress twoLevel = "2/1000"_ga;
+  assertEquals((2 << 11) | 1000, twoLevel.getValue());
+
+  knxTelegram->setTargetGroupAddress("31/7/255"_ga);
+  assertTrue(knxTelegram->getTargetGroupAddress() == "31/7/255"_ga);
+}
+
+test(receivingGroupAddressRanges) {
+  knx.addListenMiddleGroup(1, 2);
+  assertTrue(knx.isListeningToGroupAddress(GA_INTEGER(1, 2, 200)));
+  assertTrue(! knx.isListeningToGroupAddress(GA_INTEGER(1, 3, 200)));
+
+  knx.addListenMainGroup(4);
+  assertTrue(knx.isListeningToGroupAddress(GA_INTEGER(4, 7, 1)));
+  assertTrue(! knx.isListeningToGroupAddress(GA_INTEGER(5, 0, 1)));
 }
 
 test(floatValues) {
@@ -116,6 +188,20 @@ test(floatValues) {
   assertEquals(25.28 * 100.0, knxTelegram->get2ByteFloatValue() * 100); 
 }
 
+test(negativeFloatValues) {
+  knxTelegram->set2ByteFloatValue(-12.5);
+  assertEquals(-1250, (int) (knxTelegram->get2ByteFloatValue() * 100));
+}
+
+test(dptRoundTrip) {
+  knxTelegram->setValue<Dpt<5, 1> >(50);
+  assertEquals(3, knxTelegram->getPayloadLength());
+  assertEquals(50, knxTelegram->getValue<Dpt<5, 1> >());
+
+  knxTelegram->set2ByteIntValue(-300);
+  assertEquals(-300, knxTelegram->get2ByteIntValue());
+}
+
 
 void loop() {
   suite.run();
@@ -0,0 +1,352 @@
+#include "KnxCapture.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <time.h>
+#include <string>
+
+KnxCaptureWriter::KnxCaptureWriter() {
+    _records = 0;
+    _index = 0;
+    _record_count = 0;
+    _last_time = 0;
+    _time_high = 0;
+    memset(&_block, 0, sizeof(_block));
+}
+
+KnxCaptureWriter::~KnxCaptureWriter() {
+    close();
+}
+
+bool KnxCaptureWriter::open(const char* path) {
+    close();
+
+    _records = fopen(path, "wb");
+    _index = fopen((std::string(path) + KNX_CAPTURE_INDEX_SUFFIX).c_str(), "wb");
+    if (_records == 0 || _index == 0) {
+        close();
+        return false;
+    }
+
+    KnxCaptureHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, KNX_CAPTURE_MAGIC, sizeof(header.magic));
+    header.version = KNX_CAPTURE_VERSION;
+    header.recordSize = sizeof(KnxCaptureRecord);
+    header.indexInterval = KNX_CAPTURE_INDEX_INTERVAL;
+    header.created = ::time(0);
+    if (fwrite(&header, sizeof(header), 1, _records) != 1) {
+        close();
+        return false;
+    }
+
+    _record_count = 0;
+    _last_time = 0;
+    _time_high = 0;
+    memset(&_block, 0, sizeof(_block));
+    return true;
+}
+
+void KnxCaptureWriter::close() {
+    if (_index != 0 && _block.recordCount > 0) {
+        writeIndexEntry();
+    }
+    if (_records != 0) {
+        fclose(_records);
+        _records = 0;
+    }
+    if (_index != 0) {
+        fclose(_index);
+        _index = 0;
+    }
+}
+
+bool KnxCaptureWriter::write(KnxTpUartSerialEventType eventType, const byte* data, int length, unsigned long time) {
+    if (_records == 0) {
+        return false;
+    }
+
+    // micros() wraps after about 71 minutes on 32 bit targets
+    if (sizeof(unsigned long) == 4 && _record_count > 0 && time < _last_time) {
+        _time_high += 0x100000000ULL;
+    }
+    _last_time = time;
+
+    KnxCaptureRecord record;
+    memset(&record, 0, sizeof(record));
+    record.time = _time_high + time;
+    record.event = eventType;
+    record.length = length < (int) sizeof(record.data) ? length : sizeof(record.data);
+    if (length > record.length) {
+        record.flags = KNX_CAPTURE_TRUNCATED;
+    }
+    memcpy(record.data, data, record.length);
+
+    if (fwrite(&record, sizeof(record), 1, _records) != 1) {
+        return false;
+    }
+
+    if (_block.recordCount == 0) {
+        _block.firstTime = record.time;
+        _block.firstRecord = _record_count;
+    }
+    _block.lastTime = record.time;
+    _block.recordCount++;
+    bool telegram = eventType == KNX_TELEGRAM || eventType == IRRELEVANT_KNX_TELEGRAM || eventType == KNX_EXTENDED_TELEGRAM;
+    if (telegram && record.length >= KNX_EXTENDED_TELEGRAM_HEADER_SIZE) {
+        KnxTelegramView view(record.data, record.length);
+        if (view.isTargetGroup()) {
+            byte bit = KnxCaptureIndexEntry::bit(view.getTargetGroupAddress().getValue());
+            _block.groupAddresses[bit >> 3] |= 1 << (bit & 7);
+        }
+    }
+
+    _record_count++;
+    if (_block.recordCount == KNX_CAPTURE_INDEX_INTERVAL) {
+        writeIndexEntry();
+    }
+    return true;
+}
+
+uint32_t KnxCaptureWriter::getRecordCount() {
+    return _record_count;
+}
+
+void KnxCaptureWriter::rxEventCallback(KnxTpUartSerialEventType eventType, const byte* data, int length, unsigned long time, void* context) {
+    ((KnxCaptureWriter*) context)->write(eventType, data, length, time);
+}
+
+/*
+ * Completes the index entry of the current block. Records are flushed
+ * first, so an index entry never points beyond the records on disk.
+ */
+void KnxCaptureWriter::writeIndexEntry() {
+    fflush(_records);
+    fwrite(&_block, sizeof(_block), 1, _index);
+    fflush(_index);
+    memset(&_block, 0, sizeof(_block));
+}
+
+KnxCaptureReader::KnxCaptureReader() {
+    _records_map = 0;
+    _records_size = 0;
+    _index_map = 0;
+    _index_size = 0;
+    _record_count = 0;
+    _index_count = 0;
+    _index_interval = KNX_CAPTURE_INDEX_INTERVAL;
+}
+
+KnxCaptureReader::~KnxCaptureReader() {
+    close();
+}
+
+bool KnxCaptureReader::open(const char* path) {
+    close();
+
+    _records_map = mapFile(path, &_records_size);
+    if (_records_map == 0 || _records_size < sizeof(KnxCaptureHeader)) {
+        close();
+        return false;
+    }
+
+    const KnxCaptureHeader* header = (const KnxCaptureHeader*) _records_map;
+    if (memcmp(header->magic, KNX_CAPTURE_MAGIC, sizeof(header->magic)) != 0
+            || header->version != KNX_CAPTURE_VERSION
+            || header->recordSize != sizeof(KnxCaptureRecord)
+            || header->indexInterval == 0) {
+        close();
+        return false;
+    }
+    _index_interval = header->indexInterval;
+    _record_count = (_records_size - sizeof(KnxCaptureHeader)) / sizeof(KnxCaptureRecord);
+
+    // Without index every search is a scan
+    _index_map = mapFile((std::string(path) + KNX_CAPTURE_INDEX_SUFFIX).c_str(), &_index_size);
+    _index_count = _index_map != 0 ? _index_size / sizeof(KnxCaptureIndexEntry) : 0;
+    return true;
+}
+
+void KnxCaptureReader::close() {
+    if (_records_map != 0) {
+        munmap((void*) _records_map, _records_size);
+        _records_map = 0;
+    }
+    if (_index_map != 0) {
+        munmap((void*) _index_map, _index_size);
+        _index_map = 0;
+    }
+    _record_count = 0;
+    _index_count = 0;
+}
+
+uint32_t KnxCaptureReader::getRecordCount() {
+    return _record_count;
+}
+
+const KnxCaptureRecord* KnxCaptureReader::getRecord(uint32_t index) {
+    return (const KnxCaptureRecord*) (_records_map + sizeof(KnxCaptureHeader)) + index;
+}
+
+KnxTelegramView KnxCaptureReader::getTelegram(uint32_t index) {
+    const KnxCaptureRecord* record = getRecord(index);
+    return KnxTelegramView(record->data, record->length);
+}
+
+bool KnxCaptureReader::isTelegram(uint32_t index) {
+    const KnxCaptureRecord* record = getRecord(index);
+    return (record->event == KNX_TELEGRAM || record->event == IRRELEVANT_KNX_TELEGRAM)
+        && getTelegram(index).isComplete();
+}
+
+uint32_t KnxCaptureReader::findTime(uint64_t time) {
+    // Binary search on the blocks, then scan within the block
+    uint32_t first = 0;
+    uint32_t low = 0;
+    uint32_t high = _index_count;
+    while (low < high) {
+        uint32_t middle = low + (high - low) / 2;
+        if (getIndexEntry(middle)->lastTime < time) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    if (low < _index_count) {
+        first = getIndexEntry(low)->firstRecord;
+    } else if (_index_count > 0) {
+        // After the indexed blocks
+        const KnxCaptureIndexEntry* last = getIndexEntry(_index_count - 1);
+        first = last->firstRecord + last->recordCount;
+    }
+
+    for (uint32_t i = first; i < _record_count; i++) {
+        if (getRecord(i)->time >= time) {
+            return i;
+        }
+    }
+    return _record_count;
+}
+
+long KnxCaptureReader::findGroupAddress(KnxGroupAddress groupAddress, uint32_t from) {
+    uint16_t value = groupAddress.getValue();
+    byte bit = KnxCaptureIndexEntry::bit(value);
+
+    uint32_t i = from;
+    while (i < _record_count) {
+        uint32_t block = i / _index_interval;
+        if (block < _index_count && i % _index_interval == 0) {
+            const KnxCaptureIndexEntry* entry = getIndexEntry(block);
+            if ((entry->groupAddresses[bit >> 3] & (1 << (bit & 7))) == 0) {
+                // Not in this block
+                i += entry->recordCount;
+                continue;
+            }
+        }
+
+        if (isTelegram(i)) {
+            KnxTelegramView view = getTelegram(i);
+            if (view.isTargetGroup() && view.getTargetGroupAddress().getValue() == value) {
+                return i;
+            }
+        }
+        i++;
+    }
+    return -1;
+}
+
+const KnxCaptureIndexEntry* KnxCaptureReader::getIndexEntry(uint32_t index) {
+    return (const KnxCaptureIndexEntry*) _index_map + index;
+}
+
+const byte* KnxCaptureReader::mapFile(const char* path, size_t* size) {
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0) {
+        return 0;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        ::close(fd);
+        return 0;
+    }
+
+    void* map = mmap(0, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) {
+        return 0;
+    }
+    *size = st.st_size;
+    return (const byte*) map;
+}
+
+KnxCaptureReplay::KnxCaptureReplay(KnxCaptureReader* reader, unsigned int speed) {
+    _reader = reader;
+    _speed = speed;
+    seek(0);
+}
+
+void KnxCaptureReplay::seek(uint32_t record) {
+    _record = record;
+    _pos = 0;
+    _capture_start = record < _reader->getRecordCount() ? _reader->getRecord(record)->time : 0;
+    _replay_start = micros();
+}
+
+bool KnxCaptureReplay::isFinished() {
+    // Steps over a completely read record
+    available();
+    return _record >= _reader->getRecordCount();
+}
+
+uint32_t KnxCaptureReplay::getPosition() {
+    return _record;
+}
+
+bool KnxCaptureReplay::isDue(const KnxCaptureRecord* record) {
+    if (_speed == 0) {
+        return true;
+    }
+    uint64_t elapsed = (uint64_t) (micros() - _replay_start) * _speed;
+    return record->time - _capture_start <= elapsed;
+}
+
+/*
+ * Bytes of the current record, once it is due. Truncated records are
+ * skipped, a part of a frame would only be rejected.
+ */
+int KnxCaptureReplay::available() {
+    while (_record < _reader->getRecordCount()) {
+        const KnxCaptureRecord* record = _reader->getRecord(_record);
+        if (_pos < record->length && !(record->flags & KNX_CAPTURE_TRUNCATED)) {
+            return isDue(record) ? record->length - _pos : 0;
+        }
+        _record++;
+        _pos = 0;
+    }
+    return 0;
+}
+
+int KnxCaptureReplay::read() {
+    if (available() == 0) {
+        return -1;
+    }
+    return _reader->getRecord(_record)->data[_pos++];
+}
+
+int KnxCaptureReplay::peek() {
+    if (available() == 0) {
+        return -1;
+    }
+    return _reader->getRecord(_record)->data[_pos];
+}
+
+size_t KnxCaptureReplay::write(uint8_t) {
+    return 1;
+}
+
+size_t KnxCaptureReplay::write(const uint8_t*, size_t size) {
+    return size;
+}
@@ -0,0 +1,166 @@
+#ifndef KnxCapture_h
+#define KnxCapture_h
+
+#include "Arduino.h"
+
+#include "KnxTpUart.h"
+
+/*
+ * Capture of everything KnxTpUart::serialEvent() reports: relevant and
+ * irrelevant telegrams, confirmations, resets and unknown bytes.
+ *
+ * A capture is two append-only files in host byte order:
+ *
+ *   <path>      KnxCaptureHeader followed by fixed size KnxCaptureRecords,
+ *               record i is at sizeof(KnxCaptureHeader) + i * sizeof(KnxCaptureRecord)
+ *   <path>.idx  one KnxCaptureIndexEntry per KNX_CAPTURE_INDEX_INTERVAL records:
+ *               time range and a bloom filter of the group addresses
+ *
+ * Both files can be mapped into memory as arrays. A capture that was not
+ * closed has no index entry for its last block, readers scan it instead.
+ */
+
+#define KNX_CAPTURE_MAGIC "KNXCAP1"
+#define KNX_CAPTURE_VERSION 1
+#define KNX_CAPTURE_INDEX_SUFFIX ".idx"
+
+// Records per index entry
+#define KNX_CAPTURE_INDEX_INTERVAL 1024
+
+// Flags of a record: the event had more bytes than data holds, e.g. an
+// extended frame. Its checksum can't be checked and it is not replayed.
+#define KNX_CAPTURE_TRUNCATED B0001
+
+struct KnxCaptureHeader {
+    char magic[8];              // KNX_CAPTURE_MAGIC
+    uint32_t version;
+    uint32_t recordSize;        // sizeof(KnxCaptureRecord)
+    uint32_t indexInterval;     // KNX_CAPTURE_INDEX_INTERVAL of the writer
+    uint32_t reserved;
+    uint64_t created;           // wall clock time of the capture, seconds since 1970
+};
+
+struct KnxCaptureRecord {
+    uint64_t time;              // micros() of the first byte, extended to 64 bit
+    byte event;                 // KnxTpUartSerialEventType
+    byte length;                // bytes used in data
+    byte flags;                 // KNX_CAPTURE_*
+    byte reserved[5];
+    byte data[24];              // telegram, or the service byte
+};
+
+struct KnxCaptureIndexEntry {
+    uint64_t firstTime;
+    uint64_t lastTime;
+    uint32_t firstRecord;
+    uint32_t recordCount;
+    byte groupAddresses[32];    // bloom filter, see KnxCaptureIndexEntry::bit()
+
+    static byte bit(uint16_t groupAddress) {
+        return (uint16_t) (groupAddress * 40503U) >> 8;
+    }
+};
+
+static_assert(sizeof(KnxCaptureHeader) == 32, "capture header layout");
+static_assert(sizeof(KnxCaptureRecord) == 40, "capture record layout");
+static_assert(sizeof(KnxCaptureIndexEntry) == 56, "capture index layout");
+static_assert(sizeof(((KnxCaptureRecord*) 0)->data) >= MAX_KNX_TELEGRAM_SIZE, "capture record too small for a telegram");
+
+/*
+ * Appends events to a capture, usually registered with
+ * knx.setRxEventCallback(KnxCaptureWriter::rxEventCallback, &writer)
+ */
+class KnxCaptureWriter {
+    public:
+        KnxCaptureWriter();
+        ~KnxCaptureWriter();
+
+        // Creates the capture, an existing one is overwritten
+        bool open(const char* path);
+        // Writes the index entry of the last block
+        void close();
+
+        bool write(KnxTpUartSerialEventType eventType, const byte* data, int length, unsigned long time);
+        uint32_t getRecordCount();
+
+        static void rxEventCallback(KnxTpUartSerialEventType eventType, const byte* data, int length, unsigned long time, void* context);
+
+    private:
+        FILE* _records;
+        FILE* _index;
+        uint32_t _record_count;
+        unsigned long _last_time;
+        uint64_t _time_high;    // wraps of the 32 bit micros()
+        KnxCaptureIndexEntry _block;
+
+        void writeIndexEntry();
+};
+
+/*
+ * Read access to a capture through memory mapped files
+ */
+class KnxCaptureReader {
+    public:
+        KnxCaptureReader();
+        ~KnxCaptureReader();
+
+        bool open(const char* path);
+        void close();
+
+        uint32_t getRecordCount();
+        const KnxCaptureRecord* getRecord(uint32_t index);
+        // The record as telegram, no copy
+        KnxTelegramView getTelegram(uint32_t index);
+        bool isTelegram(uint32_t index);
+
+        // Index of the first record at or after time, getRecordCount() if there is none
+        uint32_t findTime(uint64_t time);
+        // Index of the next telegram to groupAddress at or after from, -1 if there is none
+        long findGroupAddress(KnxGroupAddress groupAddress, uint32_t from);
+
+    private:
+        const byte* _records_map;
+        size_t _records_size;
+        const byte* _index_map;
+        size_t _index_size;
+        uint32_t _record_count;
+        uint32_t _index_count;
+        uint32_t _index_interval;
+
+        const KnxCaptureIndexEntry* getIndexEntry(uint32_t index);
+        static const byte* mapFile(const char* path, size_t* size);
+};
+
+/*
+ * Serial port that plays a capture back into KnxTpUart. The bytes of a
+ * record become available at the record's time: speed 1 is real time,
+ * N is N times faster, 0 as fast as they are read. Written bytes are
+ * discarded.
+ */
+class KnxCaptureReplay : public Stream {
+    public:
+        KnxCaptureReplay(KnxCaptureReader* reader, unsigned int speed = 1);
+
+        // Continue with the given record, the timing restarts there
+        void seek(uint32_t record);
+        bool isFinished();
+        uint32_t getPosition();
+
+        int available();
+        int read();
+        int peek();
+        size_t write(uint8_t);
+        size_t write(const uint8_t* buffer, size_t size);
+
+    private:
+        KnxCaptureReader* _reader;
+        unsigned int _speed;
+        uint32_t _record;
+        int _pos;
+        uint64_t _capture_start;
+        unsigned long _replay_start;
+
+        bool isDue(const KnxCaptureRecord* record);
+};
+
+#endif
@@ -0,0 +1,405 @@
+#include "KnxTpUartEmulator.h"
+#include "KnxTpUart.h"
+
+KnxTpUartEmulator::KnxTpUartEmulator() {
+    _uart_tx_free = 0;
+    _uart_rx_free = 0;
+    _frame_length = 0;
+    _frame_offset = 0;
+    _expected_data = 0;
+    _service = 0;
+    _bus_free = 0;
+    _bus_busy = 0;
+    _ack_response = EMULATOR_ACK;
+    _ack_response_count = 0;
+    _lose_confirms = 0;
+    _echo = true;
+    _ack_waiting = false;
+    _ack_wait_start = 0;
+    _ack_count = 0;
+    _ack_last = -1;
+    _ack_late = 0;
+    _ack_missing = 0;
+    _ack_max_latency = 0;
+    _protocol_errors = 0;
+    _has_uart_address = false;
+    _busmon = false;
+}
+
+int KnxTpUartEmulator::available() {
+    update();
+
+    unsigned long now = micros();
+    int count = 0;
+    for (size_t i = 0; i < _rx.size() && _rx[i].time <= now; i++) {
+        count++;
+    }
+    return count;
+}
+
+int KnxTpUartEmulator::read() {
+    if (available() == 0) {
+        return -1;
+    }
+
+    byte value = _rx.front().value;
+    _rx.pop_front();
+    return value;
+}
+
+int KnxTpUartEmulator::peek() {
+    if (available() == 0) {
+        return -1;
+    }
+    return _rx.front().value;
+}
+
+size_t KnxTpUartEmulator::write(uint8_t value) {
+    update();
+    processHostByte(value, hostByteArrival());
+    return 1;
+}
+
+size_t KnxTpUartEmulator::write(const uint8_t* buffer, size_t size) {
+    update();
+    for (size_t i = 0; i < size; i++) {
+        processHostByte(buffer[i], hostByteArrival());
+    }
+    return size;
+}
+
+void KnxTpUartEmulator::injectFrame(const byte* frame, int length, unsigned long delayMicros) {
+    update();
+
+    unsigned long start = reserveBus(micros() + delayMicros, length);
+    int header = KnxTelegramView(frame, length).getHeaderSize();
+    for (int i = 0; i < length; i++) {
+        // No acknowledge expected from the host in bus monitor mode
+        schedule(start + busTime((i + 1) * TPUART_EMULATOR_BUS_CHAR_BITS), frame[i], -1, !_busmon && i == header - 1);
+    }
+    if (_busmon) {
+        schedule(start + busTime(length * TPUART_EMULATOR_BUS_CHAR_BITS + TPUART_EMULATOR_BUS_ACK_GAP_BITS
+            + TPUART_EMULATOR_BUS_ACK_BITS), KNX_BUS_ACK);
+    }
+}
+
+void KnxTpUartEmulator::injectTelegram(KnxTelegram* telegram, unsigned long delayMicros) {
+    KnxTelegram copy = *telegram;
+    copy.createChecksum();
+
+    byte frame[MAX_KNX_TELEGRAM_SIZE];
+    int length = copy.getTotalLength();
+    for (int i = 0; i < length; i++) {
+        frame[i] = copy.getBufferByte(i);
+    }
+    injectFrame(frame, length, delayMicros);
+}
+
+void KnxTpUartEmulator::injectTelegram(KnxExtendedTelegram* telegram, unsigned long delayMicros) {
+    KnxExtendedTelegram copy = *telegram;
+    copy.createChecksum();
+    injectFrame(copy.getBuffer(), copy.getTotalLength(), delayMicros);
+}
+
+void KnxTpUartEmulator::injectNoise(const byte* data, int length) {
+    update();
+    for (int i = 0; i < length; i++) {
+        schedule(micros(), data[i]);
+    }
+}
+
+void KnxTpUartEmulator::injectReset() {
+    update();
+    reset(micros());
+}
+
+void KnxTpUartEmulator::setAckResponse(KnxEmulatorAck response, int count) {
+    _ack_response = response;
+    _ack_response_count = count;
+}
+
+void KnxTpUartEmulator::loseConfirms(int count) {
+    _lose_confirms = count;
+}
+
+void KnxTpUartEmulator::setEchoEnabled(bool echo) {
+    _echo = echo;
+}
+
+int KnxTpUartEmulator::getSentFrameCount() {
+    return _sent_frames.size();
+}
+
+const KnxEmulatorFrame* KnxTpUartEmulator::getSentFrame(int index) {
+    return &_sent_frames[index];
+}
+
+int KnxTpUartEmulator::getAckInformationCount() {
+    return _ack_count;
+}
+
+int KnxTpUartEmulator::getLastAckInformation() {
+    return _ack_last;
+}
+
+int KnxTpUartEmulator::getLateAckCount() {
+    return _ack_late;
+}
+
+int KnxTpUartEmulator::getMissingAckCount() {
+    return _ack_missing;
+}
+
+unsigned long KnxTpUartEmulator::getMaxAckLatency() {
+    return _ack_max_latency;
+}
+
+int KnxTpUartEmulator::getProtocolErrorCount() {
+    return _protocol_errors;
+}
+
+bool KnxTpUartEmulator::isBusmonActive() {
+    return _busmon;
+}
+
+bool KnxTpUartEmulator::hasUartAddress() {
+    return _has_uart_address;
+}
+
+KnxIndividualAddress KnxTpUartEmulator::getUartAddress() {
+    return KnxIndividualAddress::fromBytes(_uart_address);
+}
+
+unsigned long KnxTpUartEmulator::getBusBusyMicros() {
+    return _bus_busy;
+}
+
+bool KnxTpUartEmulator::isBusIdle() {
+    return micros() >= _bus_free;
+}
+
+/*
+ * Moves the bytes the TPUART has ready by now onto the serial line
+ */
+void KnxTpUartEmulator::update() {
+    unsigned long now = micros();
+
+    while (!_events.empty() && _events.begin()->first <= now) {
+        unsigned long ready = _events.begin()->first;
+        Event event = _events.begin()->second;
+        _events.erase(_events.begin());
+
+        unsigned long start = ready > _uart_tx_free ? ready : _uart_tx_free;
+        _uart_tx_free = start + TPUART_EMULATOR_UART_CHAR_US;
+
+        RxByte rxByte;
+        rxByte.time = _uart_tx_free;
+        rxByte.value = event.value;
+        _rx.push_back(rxByte);
+
+        if (event.header) {
+            // The host has to decide about the acknowledge now
+            if (_ack_waiting) {
+                _ack_missing++;
+            }
+            _ack_waiting = true;
+            _ack_wait_start = _uart_tx_free;
+        }
+    }
+}
+
+/*
+ * Time a byte written by the host now has been received completely
+ */
+unsigned long KnxTpUartEmulator::hostByteArrival() {
+    unsigned long now = micros();
+    unsigned long start = now > _uart_rx_free ? now : _uart_rx_free;
+    _uart_rx_free = start + TPUART_EMULATOR_UART_CHAR_US;
+    return _uart_rx_free;
+}
+
+void KnxTpUartEmulator::processHostByte(byte value, unsigned long time) {
+    if (_expected_data > 0) {
+        _expected_data--;
+
+        if (_service == TPUART2_SET_ADDRESS) {
+            _address_bytes[1 - _expected_data] = value;
+            if (_expected_data == 0) {
+                _uart_address[0] = _address_bytes[0];
+                _uart_address[1] = _address_bytes[1];
+                _has_uart_address = true;
+            }
+            return;
+        }
+
+        _frame[_frame_length++] = value;
+        if ((_service & B11000000) == TPUART_DATA_END) {
+            sendFrame(time);
+        }
+        return;
+    }
+
+    _service = value;
+
+    if (value == 0x01) {
+        // U_Reset.req
+        reset(time);
+    } else if (value == 0x02) {
+        // U_State.req
+        schedule(time, TPUART_STATE_INDICATION);
+    } else if ((value & B11111000) == TPUART_ACK_INFORMATION) {
+        _ack_count++;
+        _ack_last = value;
+        if (_ack_waiting) {
+            unsigned long latency = time - _ack_wait_start;
+            if (latency > _ack_max_latency) {
+                _ack_max_latency = latency;
+            }
+            if (latency > TPUART_EMULATOR_ACK_WINDOW_US) {
+                _ack_late++;
+            }
+            _ack_waiting = false;
+        }
+    } else if (value == TPUART_ACTIVATE_BUSMON) {
+        _busmon = true;
+    } else if (value == TPUART2_SET_ADDRESS) {
+        _expected_data = 2;
+    } else if ((value & B11111000) == TPUART2_DATA_OFFSET) {
+        _frame_offset = (value & B00000111) << 6;
+    } else if ((value & B11000000) == TPUART_DATA_START_CONTINUE || (value & B11000000) == TPUART_DATA_END) {
+        int index = value & TPUART_DATA_INDEX_MASK;
+        if ((value & B11000000) == TPUART_DATA_START_CONTINUE && index == 0 && _frame_offset == 0) {
+            // U_L_DataStart
+            _frame_length = 0;
+        }
+        if ((_frame_offset | index) != _frame_length || _frame_length >= MAX_KNX_EXTENDED_TELEGRAM_SIZE) {
+            _protocol_errors++;
+            _frame_length = 0;
+            _frame_offset = 0;
+            return;
+        }
+        _expected_data = 1;
+    } else {
+        _protocol_errors++;
+    }
+}
+
+/*
+ * Puts the frame received from the host on the bus, repeats it if it was
+ * not acknowledged and confirms it to the host
+ */
+void KnxTpUartEmulator::sendFrame(unsigned long time) {
+    KnxEmulatorFrame frame;
+    for (int i = 0; i < _frame_length; i++) {
+        frame.data[i] = _frame[i];
+    }
+    frame.length = _frame_length;
+    frame.queuedTime = time;
+    frame.repetitions = 0;
+    _frame_length = 0;
+    _frame_offset = 0;
+
+    int index = _sent_frames.size();
+    byte data[MAX_KNX_EXTENDED_TELEGRAM_SIZE];
+    memcpy(data, frame.data, frame.length);
+
+    bool acked = false;
+    unsigned long earliest = time;
+    for (;;) {
+        unsigned long start = reserveBus(earliest, frame.length);
+        if (frame.repetitions == 0) {
+            frame.busStartTime = start;
+        }
+
+        if (_echo) {
+            for (int i = 0; i < frame.length; i++) {
+                schedule(start + busTime((i + 1) * TPUART_EMULATOR_BUS_CHAR_BITS), data[i], index);
+            }
+        }
+
+        KnxEmulatorAck ack = EMULATOR_ACK;
+        if (_ack_response_count != 0) {
+            ack = _ack_response;
+            if (_ack_response_count > 0) {
+                _ack_response_count--;
+            }
+        }
+
+        earliest = _bus_free;
+        acked = (ack == EMULATOR_ACK);
+        if (acked || frame.repetitions == TPUART_EMULATOR_REPETITIONS) {
+            break;
+        }
+
+        // Repetition: repeat flag cleared, the checksum changes by the same bit
+        frame.repetitions++;
+        data[0] &= B11011111;
+        data[frame.length - 1] = frame.data[frame.length - 1] ^ (frame.data[0] & B00100000);
+    }
+
+    frame.busEndTime = _bus_free;
+    frame.confirmed = acked;
+    _sent_frames.push_back(frame);
+
+    if (_lose_confirms > 0) {
+        _lose_confirms--;
+    } else {
+        schedule(_bus_free, acked ? TPUART_DATA_CONFIRM_SUCCESS : TPUART_DATA_CONFIRM_FAILED, index);
+    }
+}
+
+/*
+ * Reset of the TPUART: frames from the host not yet on the serial line are lost
+ */
+void KnxTpUartEmulator::reset(unsigned long time) {
+    std::multimap<unsigned long, Event>::iterator it = _events.begin();
+    while (it != _events.end()) {
+        if (it->second.hostFrame >= 0) {
+            _events.erase(it++);
+        } else {
+            ++it;
+        }
+    }
+
+    _frame_length = 0;
+    _frame_offset = 0;
+    _expected_data = 0;
+    _has_uart_address = false;
+    _busmon = false;
+    _ack_waiting = false;
+
+    schedule(time, TPUART_RESET_INDICATION_BYTE);
+}
+
+void KnxTpUartEmulator::schedule(unsigned long time, byte value, int hostFrame, bool header) {
+    Event event;
+    event.value = value;
+    event.hostFrame = hostFrame;
+    event.header = header;
+    _events.insert(std::make_pair(time, event));
+}
+
+/*
+ * Duration of a number of bit times on the bus in microseconds
+ */
+unsigned long KnxTpUartEmulator::busTime(unsigned long bits) {
+    return (bits * 1000000UL + 4800) / 9600;
+}
+
+/*
+ * Reserves the bus for a frame and its acknowledge, returns the start time
+ */
+unsigned long KnxTpUartEmulator::reserveBus(unsigned long earliest, int length) {
+    unsigned long idle = busTime(TPUART_EMULATOR_BUS_IDLE_BITS);
+    unsigned long start = _bus_free + idle;
+    if (earliest > start) {
+        start = earliest;
+    }
+
+    unsigned long end = start + busTime(length * TPUART_EMULATOR_BUS_CHAR_BITS
+        + TPUART_EMULATOR_BUS_ACK_GAP_BITS + TPUART_EMULATOR_BUS_ACK_BITS);
+    _bus_busy += end - start + idle;
+    _bus_free = end;
+
+    return start;
+}
@@ -0,0 +1,174 @@
+#ifndef KnxTpUartEmulator_h
+#define KnxTpUartEmulator_h
+
+#include "Arduino.h"
+
+#include <map>
+#include <deque>
+#include <vector>
+
+#include "KnxTelegram.h"
+
+// Timing of the serial line between host and TPUART: 19200 baud, 8E1 = 11 bit
+#define TPUART_EMULATOR_UART_CHAR_US 573
+
+// Bus timing in bit times at 9600 bit/s
+#define TPUART_EMULATOR_BUS_CHAR_BITS 13     // 11 bit character + 2 bit pause
+#define TPUART_EMULATOR_BUS_IDLE_BITS 50     // before a frame is sent
+#define TPUART_EMULATOR_BUS_ACK_GAP_BITS 15  // between frame and acknowledge
+#define TPUART_EMULATOR_BUS_ACK_BITS 11
+
+// U_AckInformation has to arrive this long after the address type octet
+#define TPUART_EMULATOR_ACK_WINDOW_US 1700
+
+// Repetitions of a frame which was not acknowledged
+#define TPUART_EMULATOR_REPETITIONS 3
+
+// Services from TPUART not handled by the library
+#define TPUART_STATE_INDICATION 0x07
+
+// Acknowledge of the receivers on the bus for frames sent by the host
+enum KnxEmulatorAck {
+    EMULATOR_ACK,
+    EMULATOR_NACK,
+    EMULATOR_BUSY,
+    EMULATOR_NO_ACK
+};
+
+// A frame sent by the host, as it went over the bus
+struct KnxEmulatorFrame {
+    byte data[MAX_KNX_EXTENDED_TELEGRAM_SIZE];
+    int length;
+    unsigned long queuedTime;   // U_L_DataEnd received from the host
+    unsigned long busStartTime; // first bit on the bus
+    unsigned long busEndTime;   // acknowledge of the last repetition
+    int repetitions;
+    bool confirmed;             // L_DATA.con positive
+};
+
+/*
+ * Simulated TP-UART for the host build. The library talks to it like to the
+ * serial port of a real TPUART: it parses U_L_DataStart/Continue/End,
+ * U_AckInformation, U_Reset, U_State, U_SetAddress and U_ActivateBusmon and
+ * answers with L_DATA.con, reset and state indications. In bus monitor mode
+ * injected frames are followed by the acknowledge character of the receiver.
+ *
+ * Frames sent by the host and frames injected from the bus are placed on a
+ * simulated 9600 bit/s bus, bytes reach the host with the timing of the
+ * serial line. All times come from micros() of the virtual clock, so the
+ * results do not depend on how often the host polls. There is no collision
+ * or arbitration: frames are put on the bus in the order they are scheduled.
+ */
+class KnxTpUartEmulator : public Stream {
+    public:
+        KnxTpUartEmulator();
+
+        // Serial port, as seen by the library
+        int available();
+        int read();
+        int peek();
+        size_t write(uint8_t);
+        size_t write(const uint8_t* buffer, size_t size);
+
+        // A frame from another device, starting after delayMicros when the bus is free.
+        // The frame is sent as given, so it may be truncated or have a wrong checksum.
+        void injectFrame(const byte* frame, int length, unsigned long delayMicros = 0);
+        // Same with the checksum created for the telegram
+        void injectTelegram(KnxTelegram* telegram, unsigned long delayMicros = 0);
+        void injectTelegram(KnxExtendedTelegram* telegram, unsigned long delayMicros = 0);
+        // Garbage on the serial line, delivered to the host right away
+        void injectNoise(const byte* data, int length);
+        // Spontaneous reset of the TPUART, e.g. after a bus voltage drop
+        void injectReset();
+
+        // Acknowledge of the other devices for the next count transmissions of
+        // the host (repetitions included), -1 for all of them. Afterwards frames
+        // are acknowledged again.
+        void setAckResponse(KnxEmulatorAck response, int count = -1);
+        // Drop the L_DATA.con of the next count frames
+        void loseConfirms(int count);
+        // The TPUART forwards its own frames to the host as it receives them from the bus
+        void setEchoEnabled(bool);
+
+        // Frames sent by the host
+        int getSentFrameCount();
+        const KnxEmulatorFrame* getSentFrame(int index);
+
+        // U_AckInformation sent by the host for injected frames
+        int getAckInformationCount();
+        int getLastAckInformation();
+        int getLateAckCount();      // after TPUART_EMULATOR_ACK_WINDOW_US
+        int getMissingAckCount();   // none at all for a frame
+        unsigned long getMaxAckLatency();
+
+        // Bytes from the host that are no valid service
+        int getProtocolErrorCount();
+        // U_SetAddress (TPUART2)
+        bool hasUartAddress();
+        KnxIndividualAddress getUartAddress();
+        // U_ActivateBusmon, until the next reset
+        bool isBusmonActive();
+
+        // Time the bus was busy, including idle time before frames and acknowledges
+        unsigned long getBusBusyMicros();
+        bool isBusIdle();
+
+    private:
+        struct Event {
+            byte value;
+            int hostFrame;      // index in _sent_frames for echo and confirm, -1 otherwise
+            bool header;        // address type octet of an injected frame
+        };
+
+        struct RxByte {
+            unsigned long time;
+            byte value;
+        };
+
+        // Bytes to the host ordered by the time the TPUART has them ready
+        std::multimap<unsigned long, Event> _events;
+        // Bytes on the serial line to the host, in order
+        std::deque<RxByte> _rx;
+        unsigned long _uart_tx_free;
+        unsigned long _uart_rx_free;
+
+        // Host service being parsed
+        byte _frame[MAX_KNX_EXTENDED_TELEGRAM_SIZE];
+        int _frame_length;
+        int _frame_offset;      // U_L_DataOffset (TPUART2), index of the next bytes from 64 on
+        int _expected_data;     // data bytes still expected for the last service
+        byte _service;
+        byte _address_bytes[2];
+
+        std::vector<KnxEmulatorFrame> _sent_frames;
+        unsigned long _bus_free;
+        unsigned long _bus_busy;
+        KnxEmulatorAck _ack_response;
+        int _ack_response_count;
+        int _lose_confirms;
+        bool _echo;
+
+        bool _ack_waiting;
+        unsigned long _ack_wait_start;
+        int _ack_count;
+        int _ack_last;
+        int _ack_late;
+        int _ack_missing;
+        unsigned long _ack_max_latency;
+
+        int _protocol_errors;
+        bool _has_uart_address;
+        bool _busmon;
+        byte _uart_address[2];
+
+        void update();
+        unsigned long hostByteArrival();
+        void processHostByte(byte value, unsigned long time);
+        void sendFrame(unsigned long time);
+        void reset(unsigned long time);
+        void schedule(unsigned long time, byte value, int hostFrame = -1, bool header = false);
+        unsigned long busTime(unsigned long bits);
+        unsigned long reserveBus(unsigned long earliest, int length);
+};
+
+#endif
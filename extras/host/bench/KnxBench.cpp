@@ -0,0 +1,86 @@
+/*
+ * Host runner for the microbenchmarks in examples/Benchmark/KnxBenchmarks.h
+ * Reports wall clock ns/op, heap allocations per operation and failed
+ * operations, which make it exit with 1.
+ *
+ *   KnxBench [filter]   runs the benchmarks whose name contains filter
+ */
+#include <new>
+#include <time.h>
+
+#include "KnxBenchmarks.h"
+
+// Minimum wall clock time per benchmark
+#define BENCH_MIN_NS 200000000ULL
+
+static unsigned long long allocations = 0;
+
+void* operator new(size_t size) {
+    allocations++;
+    void* p = malloc(size ? size : 1);
+    if (p == 0) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* p) noexcept {
+    free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    free(p);
+}
+
+static unsigned long long nowNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static unsigned long long runBatch(KnxBenchFunction run, unsigned long iterations) {
+    unsigned long long start = nowNs();
+    for (unsigned long i = 0; i < iterations; i++) {
+        run();
+    }
+    return nowNs() - start;
+}
+
+int main(int argc, char** argv) {
+    const char* filter = argc > 1 ? argv[1] : "";
+    knxBenchSetup();
+
+    int result = 0;
+    printf("%-28s %12s %12s %8s\n", "benchmark", "ns/op", "allocs/op", "failed");
+    for (unsigned int b = 0; b < KNX_BENCHMARK_COUNT; b++) {
+        const KnxBenchmark& bench = knxBenchmarks[b];
+        if (strstr(bench.name, filter) == 0) {
+            continue;
+        }
+
+        // Warm up and find an iteration count that runs long enough
+        unsigned long iterations = 1000;
+        unsigned long long elapsed = runBatch(bench.run, iterations);
+        while (elapsed < BENCH_MIN_NS / 10) {
+            iterations *= 4;
+            elapsed = runBatch(bench.run, iterations);
+        }
+        iterations = (unsigned long) (iterations * (double) BENCH_MIN_NS / elapsed) + 1;
+
+        unsigned long long allocationsBefore = allocations;
+        knxBenchFailures = 0;
+        elapsed = runBatch(bench.run, iterations);
+        unsigned long long allocated = allocations - allocationsBefore;
+
+        printf("%-28s %12.1f %12.2f %8lu\n", bench.name,
+            (double) elapsed / iterations, (double) allocated / iterations, knxBenchFailures);
+        if (knxBenchFailures > 0) {
+            result = 1;
+        }
+    }
+    return result;
+}
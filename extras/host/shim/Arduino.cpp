@@ -0,0 +1,133 @@
+#include "Arduino.h"
+
+HostSerial Serial;
+
+static unsigned long hostMicros = 0;
+static int hostPins[64];
+
+unsigned long millis() {
+    return hostMicros / 1000;
+}
+
+unsigned long micros() {
+    return hostMicros;
+}
+
+void delay(unsigned long ms) {
+    hostMicros += ms * 1000;
+}
+
+void delayMicroseconds(unsigned int us) {
+    hostMicros += us;
+}
+
+void hostAdvanceMicros(unsigned long us) {
+    hostMicros += us;
+}
+
+void hostSetMicros(unsigned long us) {
+    hostMicros = us;
+}
+
+void pinMode(int, int) {
+}
+
+int digitalRead(int pin) {
+    return (pin >= 0 && pin < 64) ? hostPins[pin] : LOW;
+}
+
+void digitalWrite(int pin, int value) {
+    hostSetPin(pin, value);
+}
+
+void hostSetPin(int pin, int value) {
+    if (pin >= 0 && pin < 64) {
+        hostPins[pin] = value;
+    }
+}
+
+/*
+ * String
+ */
+static std::string formatNumber(unsigned long value, int base) {
+    if (base < 2) {
+        base = DEC;
+    }
+    char buf[8 * sizeof(long) + 1];
+    char* p = &buf[sizeof(buf) - 1];
+    *p = 0;
+    do {
+        int digit = value % base;
+        *--p = digit < 10 ? '0' + digit : 'A' + digit - 10;
+        value /= base;
+    } while (value != 0);
+    return std::string(p);
+}
+
+static std::string formatNumber(long value, int base) {
+    if (value < 0 && base == DEC) {
+        return "-" + formatNumber((unsigned long) -value, base);
+    }
+    return formatNumber((unsigned long) value, base);
+}
+
+static std::string formatFloat(double value, int decimals) {
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%.*f", decimals, value);
+    return std::string(buf);
+}
+
+String::String(int value, int base) : _s(formatNumber((long) value, base)) {}
+String::String(long value, int base) : _s(formatNumber(value, base)) {}
+String::String(unsigned int value, int base) : _s(formatNumber((unsigned long) value, base)) {}
+String::String(unsigned long value, int base) : _s(formatNumber(value, base)) {}
+String::String(double value, int decimals) : _s(formatFloat(value, decimals)) {}
+
+String String::substring(unsigned int from, unsigned int to) const {
+    if (from > to) {
+        unsigned int tmp = from;
+        from = to;
+        to = tmp;
+    }
+    if (from >= _s.length()) {
+        return String();
+    }
+    return String(_s.substr(from, to - from));
+}
+
+void String::toCharArray(char* buf, unsigned int size) const {
+    if (size == 0) {
+        return;
+    }
+    strncpy(buf, _s.c_str(), size - 1);
+    buf[size - 1] = 0;
+}
+
+void String::trim() {
+    size_t first = _s.find_first_not_of(" \t\r\n");
+    size_t last = _s.find_last_not_of(" \t\r\n");
+    _s = (first == std::string::npos) ? std::string() : _s.substr(first, last - first + 1);
+}
+
+/*
+ * Print
+ */
+size_t Print::write(const uint8_t* buffer, size_t size) {
+    size_t n = 0;
+    while (size--) {
+        n += write(*buffer++);
+    }
+    return n;
+}
+
+size_t Print::print(long value, int base) {
+    return print(String(value, base));
+}
+
+size_t Print::print(unsigned long value, int base) {
+    return print(String(value, base));
+}
+
+size_t Print::print(double value, int decimals) {
+    return print(String(value, decimals));
+}
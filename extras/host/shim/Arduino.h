@@ -0,0 +1,148 @@
+#ifndef Arduino_h
+#define Arduino_h
+
+/*
+ * Minimal Arduino core for building the library on a Linux host.
+ * Time is virtual: millis()/micros() only advance through delay(),
+ * delayMicroseconds() or hostAdvanceMicros(), so runs are deterministic.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+
+#include "binary.h"
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+// Arduino's macros, std::round/abs don't accept all the types used by sketches
+#undef abs
+#define abs(x) ((x) > 0 ? (x) : -(x))
+#undef round
+#define round(x) ((x) >= 0 ? (long) ((x) + 0.5) : (long) ((x) - 0.5))
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+// No interrupts on the host
+inline void noInterrupts() {}
+inline void interrupts() {}
+
+// Virtual clock of the host build
+void hostAdvanceMicros(unsigned long us);
+void hostSetMicros(unsigned long us);
+
+// Pins are not connected, digitalRead() returns what was set with hostSetPin()
+void pinMode(int pin, int mode);
+int digitalRead(int pin);
+void digitalWrite(int pin, int value);
+void hostSetPin(int pin, int value);
+
+class String {
+    public:
+        String(const char* s = "") : _s(s) {}
+        String(const std::string& s) : _s(s) {}
+        String(char c) : _s(1, c) {}
+        String(int value, int base = DEC);
+        String(long value, int base = DEC);
+        String(unsigned int value, int base = DEC);
+        String(unsigned long value, int base = DEC);
+        String(double value, int decimals = 2);
+
+        unsigned int length() const { return _s.length(); }
+        const char* c_str() const { return _s.c_str(); }
+        char charAt(unsigned int index) const { return index < _s.length() ? _s[index] : 0; }
+        char operator[](unsigned int index) const { return charAt(index); }
+
+        int indexOf(char c) const { return toIndex(_s.find(c)); }
+        int indexOf(char c, unsigned int from) const { return toIndex(_s.find(c, from)); }
+        int lastIndexOf(char c) const { return toIndex(_s.rfind(c)); }
+        String substring(unsigned int from) const { return substring(from, _s.length()); }
+        String substring(unsigned int from, unsigned int to) const;
+
+        long toInt() const { return atol(_s.c_str()); }
+        float toFloat() const { return atof(_s.c_str()); }
+        void toCharArray(char* buf, unsigned int size) const;
+        void trim();
+
+        String& operator+=(const String& other) { _s += other._s; return *this; }
+        String& operator+=(const char* other) { _s += other; return *this; }
+        String& operator+=(char c) { _s += c; return *this; }
+        bool operator==(const String& other) const { return _s == other._s; }
+        bool operator==(const char* other) const { return _s == other; }
+        bool operator!=(const String& other) const { return _s != other._s; }
+
+        friend String operator+(const String& a, const String& b) { return String(a._s + b._s); }
+
+    private:
+        std::string _s;
+
+        static int toIndex(size_t pos) { return pos == std::string::npos ? -1 : (int) pos; }
+};
+
+class Print {
+    public:
+        virtual ~Print() {}
+        virtual size_t write(uint8_t) = 0;
+        virtual size_t write(const uint8_t* buffer, size_t size);
+        size_t write(const char* s) { return write((const uint8_t*) s, strlen(s)); }
+
+        size_t print(const char* s) { return write(s); }
+        size_t print(const String& s) { return write(s.c_str()); }
+        size_t print(char c) { return write((uint8_t) c); }
+        size_t print(unsigned char value, int base = DEC) { return print((unsigned long) value, base); }
+        size_t print(int value, int base = DEC) { return print((long) value, base); }
+        size_t print(unsigned int value, int base = DEC) { return print((unsigned long) value, base); }
+        size_t print(long value, int base = DEC);
+        size_t print(unsigned long value, int base = DEC);
+        size_t print(double value, int decimals = 2);
+
+        size_t println() { return write("\r\n"); }
+        template<class T> size_t println(const T& value) { size_t n = print(value); return n + println(); }
+        template<class T> size_t println(const T& value, int format) { size_t n = print(value, format); return n + println(); }
+};
+
+class Stream : public Print {
+    public:
+        virtual int available() = 0;
+        virtual int read() = 0;
+        virtual int peek() = 0;
+        virtual void flush() {}
+};
+
+/*
+ * Serial port of the host: output goes to stdout, there is no input
+ */
+class HostSerial : public Stream {
+    public:
+        void begin(unsigned long, int = 0) {}
+        void end() {}
+        size_t write(uint8_t b) { return fwrite(&b, 1, 1, stdout); }
+        size_t write(const uint8_t* buffer, size_t size) { return fwrite(buffer, 1, size, stdout); }
+        int available() { return 0; }
+        int read() { return -1; }
+        int peek() { return -1; }
+        void flush() { fflush(stdout); }
+        operator bool() { return true; }
+};
+
+extern HostSerial Serial;
+
+#endif
@@ -0,0 +1,23 @@
+#ifndef EEPROM_h
+#define EEPROM_h
+
+#include "Arduino.h"
+
+/*
+ * EEPROM kept in RAM, erased (0xFF) at start
+ */
+class EEPROMClass {
+    public:
+        EEPROMClass() { memset(_data, 0xFF, sizeof(_data)); }
+        uint8_t read(int index) { return _data[index & (sizeof(_data) - 1)]; }
+        void write(int index, uint8_t value) { _data[index & (sizeof(_data) - 1)] = value; }
+        void update(int index, uint8_t value) { write(index, value); }
+        int length() { return sizeof(_data); }
+
+    private:
+        uint8_t _data[1024];
+};
+
+static EEPROMClass EEPROM;
+
+#endif
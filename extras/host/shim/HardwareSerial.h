@@ -0,0 +1,7 @@
+#ifndef HardwareSerial_h
+#define HardwareSerial_h
+
+// Stream and the host Serial are declared in Arduino.h
+#include "Arduino.h"
+
+#endif
@@ -0,0 +1,201 @@
+/*
+ * Recording the bus with KnxCaptureWriter and replaying it into KnxTpUart
+ */
+#include "KnxTpUart.h"
+#include "KnxTpUartEmulator.h"
+#include "KnxCapture.h"
+
+static int failures = 0;
+
+#define CHECK(condition) \
+    if (!(condition)) { \
+        printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+        failures++; \
+    }
+
+#define LOOP_US 100
+
+static const char* capturePath = "/tmp/KnxCaptureTest.knxcap";
+
+static int run(KnxTpUart* knx, unsigned long us, KnxTpUartSerialEventType event) {
+    int count = 0;
+    unsigned long end = micros() + us;
+    while (micros() < end) {
+        if (knx->serialEvent() == event) {
+            count++;
+        }
+        knx->loop();
+        hostAdvanceMicros(LOOP_US);
+    }
+    return count;
+}
+
+static void injectWrite(KnxTpUartEmulator* tpuart, KnxGroupAddress groupAddress, float value) {
+    KnxTelegram telegram;
+    telegram.setSourceAddress("1.1.20"_pa);
+    telegram.setTargetGroupAddress(groupAddress);
+    telegram.setCommand(KNX_COMMAND_WRITE);
+    telegram.set2ByteFloatValue(value);
+    tpuart->injectTelegram(&telegram, 10000);
+}
+
+static void testRecordAndReplay() {
+    KnxTpUartEmulator tpuart;
+    KnxTpUart knx(&tpuart, "1.1.10"_pa);
+    knx.addListenGroupAddress("0/0/3"_ga);
+
+    KnxCaptureWriter writer;
+    CHECK(writer.open(capturePath));
+    knx.setRxEventCallback(KnxCaptureWriter::rxEventCallback, &writer);
+
+    // Relevant and irrelevant telegrams, our own frame with its confirmation, a reset
+    unsigned long start = micros();
+    injectWrite(&tpuart, "0/0/3"_ga, 21.5);
+    injectWrite(&tpuart, "0/0/4"_ga, 10.0);
+    injectWrite(&tpuart, "0/0/3"_ga, 22.0);
+    run(&knx, 200000, KNX_TELEGRAM);
+    knx.groupWriteBool("1/2/3"_ga, true);
+    run(&knx, 100000, KNX_TELEGRAM);
+    tpuart.injectReset();
+    run(&knx, 10000, KNX_TELEGRAM);
+    writer.close();
+
+    KnxCaptureReader reader;
+    CHECK(reader.open(capturePath));
+    // 3 injected, echo of our frame, confirmation, reset
+    CHECK(reader.getRecordCount() == 6);
+    CHECK(reader.getRecord(0)->event == KNX_TELEGRAM);
+    CHECK(reader.getRecord(0)->time >= start);
+    CHECK(reader.getRecord(1)->event == IRRELEVANT_KNX_TELEGRAM);
+    CHECK(reader.getRecord(4)->event == TPUART_DATA_CONFIRM);
+    CHECK(reader.getRecord(5)->event == TPUART_RESET_INDICATION);
+    CHECK(reader.getTelegram(2).get2ByteFloatValue() == 22.0);
+    CHECK(reader.getTelegram(1).verifyChecksum());
+
+    CHECK(reader.findGroupAddress("0/0/3"_ga, 0) == 0);
+    CHECK(reader.findGroupAddress("0/0/3"_ga, 1) == 2);
+    CHECK(reader.findGroupAddress("0/0/5"_ga, 0) == -1);
+    CHECK(reader.findTime(reader.getRecord(3)->time) == 3);
+
+    // Same events again, as fast as possible
+    KnxCaptureReplay replay(&reader, 0);
+    KnxTpUart replayed(&replay, "1.1.10"_pa);
+    replayed.addListenGroupAddress("0/0/3"_ga);
+    int telegrams = 0;
+    int irrelevant = 0;
+    int other = 0;
+    while (!replay.isFinished()) {
+        KnxTpUartSerialEventType event = replayed.serialEvent();
+        if (event == KNX_TELEGRAM) {
+            telegrams++;
+        } else if (event == IRRELEVANT_KNX_TELEGRAM) {
+            irrelevant++;
+        } else if (event == TPUART_DATA_CONFIRM || event == TPUART_RESET_INDICATION) {
+            other++;
+        }
+    }
+    CHECK(telegrams == 2);
+    CHECK(irrelevant == 2);
+    CHECK(other == 2);
+}
+
+static void testReplayTiming() {
+    KnxCaptureReader reader;
+    CHECK(reader.open(capturePath));
+
+    // 10 times faster than recorded
+    KnxCaptureReplay replay(&reader, 10);
+    KnxTpUart knx(&replay, "1.1.10"_pa);
+    uint64_t duration = reader.getRecord(reader.getRecordCount() - 1)->time - reader.getRecord(0)->time;
+
+    unsigned long start = micros();
+    while (!replay.isFinished()) {
+        knx.serialEvent();
+        hostAdvanceMicros(LOOP_US);
+    }
+    unsigned long elapsed = micros() - start;
+    CHECK(elapsed >= duration / 10);
+    // Polled every LOOP_US, plus the step after the last event
+    CHECK(elapsed <= duration / 10 + 2 * LOOP_US);
+}
+
+static void testTruncated() {
+    KnxTpUartEmulator tpuart;
+    KnxTpUart knx(&tpuart, "1.1.10"_pa);
+    KnxCaptureWriter writer;
+    CHECK(writer.open(capturePath));
+    knx.setRxEventCallback(KnxCaptureWriter::rxEventCallback, &writer);
+
+    // An extended frame longer than a record, then a standard one
+    KnxExtendedTelegram extended;
+    extended.setSourceAddress("1.1.20"_pa);
+    extended.setTargetIndividualAddress("1.1.30"_pa);
+    extended.setCommand(KNX_COMMAND_MEM_WRITE);
+    byte data[60] = {0};
+    extended.setData(data, sizeof(data));
+    tpuart.injectTelegram(&extended);
+    injectWrite(&tpuart, "0/0/4"_ga, 10.0);
+    CHECK(run(&knx, 200000, IRRELEVANT_KNX_TELEGRAM) == 2);
+    writer.close();
+
+    KnxCaptureReader reader;
+    CHECK(reader.open(capturePath));
+    CHECK(reader.getRecordCount() == 2);
+    CHECK(reader.getRecord(0)->flags == KNX_CAPTURE_TRUNCATED);
+    CHECK(reader.getRecord(0)->length == sizeof(reader.getRecord(0)->data));
+    CHECK(!reader.isTelegram(0));
+    CHECK(reader.getRecord(1)->flags == 0);
+    CHECK(reader.isTelegram(1));
+
+    // Not replayed, it would only be rejected
+    KnxCaptureReplay replay(&reader, 0);
+    CHECK(replay.read() == reader.getRecord(1)->data[0]);
+}
+
+static void testIndex() {
+    KnxCaptureWriter writer;
+    CHECK(writer.open(capturePath));
+
+    // 2.5 blocks, 9/9/9 only in the last one
+    KnxTelegram telegram;
+    telegram.setTargetGroupAddress("1/1/1"_ga);
+    telegram.createChecksum();
+    byte frame[MAX_KNX_TELEGRAM_SIZE];
+    int count = KNX_CAPTURE_INDEX_INTERVAL * 5 / 2;
+    for (int i = 0; i < count; i++) {
+        if (i == count - 10) {
+            telegram.setTargetGroupAddress("9/1/9"_ga);
+            telegram.createChecksum();
+        }
+        for (int j = 0; j < telegram.getTotalLength(); j++) {
+            frame[j] = telegram.getBufferByte(j);
+        }
+        writer.write(IRRELEVANT_KNX_TELEGRAM, frame, telegram.getTotalLength(), 1000UL * i);
+    }
+    writer.close();
+
+    KnxCaptureReader reader;
+    CHECK(reader.open(capturePath));
+    CHECK(reader.getRecordCount() == (uint32_t) count);
+    CHECK(reader.findTime(1000UL * 1500) == 1500);
+    CHECK(reader.findTime(1000UL * 1500 - 1) == 1500);
+    CHECK(reader.findTime(1000ULL * count) == (uint32_t) count);
+    CHECK(reader.findGroupAddress("9/1/9"_ga, 0) == count - 10);
+    CHECK(reader.findGroupAddress("1/1/1"_ga, 2000) == 2000);
+}
+
+int main() {
+    testRecordAndReplay();
+    testReplayTiming();
+    testTruncated();
+    testIndex();
+    remove(capturePath);
+    remove((std::string(capturePath) + KNX_CAPTURE_INDEX_SUFFIX).c_str());
+
+    if (failures > 0) {
+        printf("CaptureTest: %d failures\n", failures);
+        return 1;
+    }
+    printf("CaptureTest: ok\n");
+    return 0;
+}
@@ -0,0 +1,286 @@
+/*
+ * Encoding and decoding of the datapoint types in KnxDpt.h: every DPT 9
+ * value, the boundaries and signs of the others
+ */
+#include "KnxTpUart.h"
+
+static int failures = 0;
+
+#define CHECK(condition) \
+    if (!(condition)) { \
+        printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+        failures++; \
+    }
+
+// APCI byte and the data bytes of the longest DPT, the APCI bits of a group write set
+#define APCI_BITS B10000000
+
+static void clearData(byte* data) {
+    data[0] = APCI_BITS;
+    for (int i = 1; i <= 14; i++) {
+        data[i] = 0;
+    }
+}
+
+template<class D> static typename D::Type roundTrip(const typename D::Type& value) {
+    byte data[15];
+    clearData(data);
+    D::encode(value, data);
+    return D::decode(data);
+}
+
+/*
+ * All 16 exponents with all 4096 mantissas: the value comes back exactly,
+ * encoded with the smallest exponent it fits
+ */
+static void testDpt9Exhaustive() {
+    typedef Dpt<9> D;
+    byte data[3];
+    byte encoded[3];
+    for (int exponent = 0; exponent < 16; exponent++) {
+        for (long mantissa = -2048; mantissa < 2048; mantissa++) {
+            unsigned int bits = mantissa & 0x7FF;
+            data[1] = (mantissa < 0 ? B10000000 : 0) | (exponent << 3) | (bits >> 8);
+            data[2] = bits & 0xFF;
+            long centi = D::decodeCenti(data);
+            CHECK(centi == mantissa * (1L << exponent));
+
+            D::encodeCenti(centi, encoded);
+            CHECK(D::decodeCenti(encoded) == centi);
+            int encodedExponent = (encoded[1] & B01111000) >> 3;
+            CHECK(encodedExponent <= exponent);
+            if (mantissa < -1024 || mantissa >= 1024 || exponent == 0) {
+                // Already the smallest exponent
+                CHECK(encoded[1] == data[1] && encoded[2] == data[2]);
+            }
+        }
+    }
+
+    // Rounded to the nearest step, beyond the range clamped
+    D::encodeCenti(2049, encoded);
+    CHECK(D::decodeCenti(encoded) == 2050);
+    D::encodeCenti(-2049, encoded);
+    CHECK(D::decodeCenti(encoded) == -2050);
+    D::encodeCenti(D::MAX_CENTI + 1, encoded);
+    CHECK(D::decodeCenti(encoded) == D::MAX_CENTI);
+    D::encodeCenti(D::MIN_CENTI - 1, encoded);
+    CHECK(D::decodeCenti(encoded) == D::MIN_CENTI);
+
+    CHECK(roundTrip<D>(21.5) == 21.5f);
+    CHECK(roundTrip<D>(-30.0) == -30.0f);
+    CHECK(roundTrip<D>(0.0) == 0.0f);
+    CHECK(roundTrip<D>(1e9) == D::MAX_CENTI * 0.01f);
+    CHECK(roundTrip<D>(-1e9) == D::MIN_CENTI * 0.01f);
+}
+
+static void testSmall() {
+    byte data[15];
+
+    // The APCI bits above the value are kept
+    clearData(data);
+    Dpt<1>::encode(true, data);
+    CHECK(data[0] == (APCI_BITS | 1) && Dpt<1>::decode(data));
+    Dpt<1>::encode(false, data);
+    CHECK(data[0] == APCI_BITS && !Dpt<1>::decode(data));
+
+    for (int i = 0; i < 4; i++) {
+        KnxDptControl control = { (i & 2) != 0, (i & 1) != 0 };
+        clearData(data);
+        Dpt<2>::encode(control, data);
+        CHECK(data[0] == (APCI_BITS | i));
+        KnxDptControl decoded = Dpt<2>::decode(data);
+        CHECK(decoded.control == control.control && decoded.value == control.value);
+    }
+
+    for (int i = 0; i < 16; i++) {
+        KnxDptStep step = { (i & B1000) != 0, (byte) (i & B111) };
+        clearData(data);
+        Dpt<3>::encode(step, data);
+        CHECK(data[0] == (APCI_BITS | i));
+        KnxDptStep decoded = Dpt<3>::decode(data);
+        CHECK(decoded.control == step.control && decoded.stepCode == step.stepCode);
+    }
+    // A step code beyond 3 bit doesn't reach the control bit
+    KnxDptStep step = { false, 8 };
+    clearData(data);
+    Dpt<3>::encode(step, data);
+    CHECK(data[0] == APCI_BITS);
+}
+
+static void testBytes() {
+    typedef Dpt<5, 1> Percent;
+    typedef Dpt<5, 3> Angle;
+    byte data[15];
+
+    CHECK(roundTrip<Dpt<5> >(0) == 0);
+    CHECK(roundTrip<Dpt<5> >(255) == 255);
+
+    // 5.001: every percent comes back, the ends are 0 and 255
+    for (int percent = 0; percent <= 100; percent++) {
+        CHECK(roundTrip<Percent>(percent) == percent);
+    }
+    clearData(data);
+    Percent::encode(100, data);
+    CHECK(data[1] == 255);
+    Percent::encode(101, data);
+    CHECK(data[1] == 255);
+    Percent::encode(0, data);
+    CHECK(data[1] == 0);
+
+    // 5.003: clamped to 0..360
+    CHECK(roundTrip<Angle>(0) == 0);
+    CHECK(roundTrip<Angle>(360) == 360);
+    CHECK(roundTrip<Angle>(-1) == 0);
+    CHECK(roundTrip<Angle>(400) == 360);
+
+    clearData(data);
+    Dpt<6>::encode(-128, data);
+    CHECK(data[1] == 0x80 && Dpt<6>::decode(data) == -128);
+    Dpt<6>::encode(-1, data);
+    CHECK(data[1] == 0xFF && Dpt<6>::decode(data) == -1);
+    CHECK(roundTrip<Dpt<6> >(127) == 127);
+
+    // Big endian
+    clearData(data);
+    Dpt<7>::encode(0x1234, data);
+    CHECK(data[1] == 0x12 && data[2] == 0x34);
+    CHECK(roundTrip<Dpt<7> >(0) == 0);
+    CHECK(roundTrip<Dpt<7> >(65535) == 65535);
+
+    clearData(data);
+    Dpt<8>::encode(-1, data);
+    CHECK(data[1] == 0xFF && data[2] == 0xFF);
+    CHECK(roundTrip<Dpt<8> >(-32768) == -32768);
+    CHECK(roundTrip<Dpt<8> >(32767) == 32767);
+
+    CHECK(roundTrip<Dpt<12> >(0) == 0);
+    CHECK(roundTrip<Dpt<12> >(0xFFFFFFFFUL) == 0xFFFFFFFFUL);
+    clearData(data);
+    Dpt<12>::encode(0x12345678UL, data);
+    CHECK(data[1] == 0x12 && data[2] == 0x34 && data[3] == 0x56 && data[4] == 0x78);
+
+    CHECK(roundTrip<Dpt<13> >(INT32_MIN) == INT32_MIN);
+    CHECK(roundTrip<Dpt<13> >(INT32_MAX) == INT32_MAX);
+    CHECK(roundTrip<Dpt<13> >(-1) == -1);
+
+    // IEEE 754 as on the bus, the sign of zero too
+    clearData(data);
+    Dpt<14>::encode(1234.5f, data);
+    CHECK(data[1] == 0x44 && data[2] == 0x9A && data[3] == 0x50 && data[4] == 0x00);
+    Dpt<14>::encode(-0.0f, data);
+    CHECK(data[1] == 0x80 && signbit(Dpt<14>::decode(data)));
+    CHECK(roundTrip<Dpt<14> >(-3.4e38f) == -3.4e38f);
+    CHECK(isinf(roundTrip<Dpt<14> >(INFINITY)));
+
+    CHECK(roundTrip<Dpt<17> >(63) == 63);
+    CHECK(roundTrip<Dpt<17> >(64) == 0);
+
+    KnxDptSceneControl scene = { true, 63 };
+    clearData(data);
+    Dpt<18>::encode(scene, data);
+    CHECK(data[1] == 0xBF);
+    KnxDptSceneControl decodedScene = Dpt<18>::decode(data);
+    CHECK(decodedScene.learn && decodedScene.scene == 63);
+    scene.learn = false;
+    scene.scene = 64;
+    Dpt<18>::encode(scene, data);
+    CHECK(data[1] == 0);
+
+    CHECK(roundTrip<Dpt<20> >(0) == 0);
+    CHECK(roundTrip<Dpt<20> >(255) == 255);
+}
+
+static void testTime() {
+    byte data[15];
+
+    KnxDptTime time = { 7, 23, 59, 59 };
+    KnxDptTime decodedTime = roundTrip<Dpt<10> >(time);
+    CHECK(decodedTime.day == 7 && decodedTime.hour == 23 && decodedTime.minute == 59 && decodedTime.second == 59);
+    // Out of range fields don't spill into the neighbouring ones
+    KnxDptTime invalid = { 0, 32, 64, 64 };
+    clearData(data);
+    Dpt<10>::encode(invalid, data);
+    CHECK(data[1] == 0 && data[2] == 0 && data[3] == 0);
+
+    // The two digit year covers 1990..2089
+    KnxDptDate date = { 31, 12, 1990 };
+    KnxDptDate decodedDate = roundTrip<Dpt<11> >(date);
+    CHECK(decodedDate.day == 31 && decodedDate.month == 12 && decodedDate.year == 1990);
+    date.year = 2089;
+    CHECK(roundTrip<Dpt<11> >(date).year == 2089);
+    date.year = 2000;
+    CHECK(roundTrip<Dpt<11> >(date).year == 2000);
+
+    KnxDptDateTime dateTime = { 1900, 1, 1, 1, 0, 0, 0, 0 };
+    KnxDptDateTime decoded = roundTrip<Dpt<19> >(dateTime);
+    CHECK(decoded.year == 1900 && decoded.month == 1 && decoded.day == 1 && decoded.dayOfWeek == 1);
+    KnxDptDateTime last = { 2155, 12, 31, 7, 24, 59, 59, 0xFFFF };
+    decoded = roundTrip<Dpt<19> >(last);
+    CHECK(decoded.year == 2155 && decoded.month == 12 && decoded.day == 31 && decoded.dayOfWeek == 7);
+    CHECK(decoded.hour == 24 && decoded.minute == 59 && decoded.second == 59 && decoded.flags == 0xFFFF);
+    clearData(data);
+    Dpt<19>::encode(last, data);
+    CHECK(data[1] == 255 && data[7] == 0xFF && data[8] == 0xFF);
+}
+
+/*
+ * 14 bytes padded with 0, not terminated when all are used
+ */
+static void testString() {
+    byte data[15];
+
+    clearData(data);
+    memset(&data[1], 'x', 14);
+    Dpt<16>::encode("Kitchen", data);
+    CHECK(memcmp(&data[1], "Kitchen", 7) == 0);
+    for (int i = 8; i <= 14; i++) {
+        CHECK(data[i] == 0);
+    }
+    CHECK(strcmp(Dpt<16>::decode(data).text, "Kitchen") == 0);
+
+    Dpt<16>::encode("Kitchen window", data);
+    CHECK(memcmp(&data[1], "Kitchen window", 14) == 0);
+    KnxDptString decoded = Dpt<16>::decode(data);
+    CHECK(decoded.text[14] == 0 && strcmp(decoded.text, "Kitchen window") == 0);
+
+    // Longer texts are cut off at 14 characters
+    Dpt<16>::encode("Kitchen window left", data);
+    CHECK(strcmp(Dpt<16>::decode(data).text, "Kitchen window") == 0);
+
+    Dpt<16>::encode("", data);
+    for (int i = 1; i <= 14; i++) {
+        CHECK(data[i] == 0);
+    }
+    CHECK(Dpt<16>::decode(data).text[0] == 0);
+
+    KnxDptString value;
+    strcpy(value.text, "Hall");
+    CHECK(strcmp(roundTrip<Dpt<16> >(value).text, "Hall") == 0);
+
+    // The telegram methods go through the codec
+    KnxTelegram telegram;
+    for (int i = 8; i < MAX_KNX_TELEGRAM_SIZE; i++) {
+        telegram.setBufferByte(i, 'x');
+    }
+    telegram.set14ByteValue("Kitchen");
+    CHECK(telegram.getPayloadLength() == Dpt<16>::PAYLOAD_LENGTH);
+    CHECK(telegram.getBufferByte(8 + 7) == 0 && telegram.getBufferByte(8 + 13) == 0);
+    CHECK(telegram.get14ByteValue("") == "Kitchen");
+    telegram.set14ByteValue("Kitchen window left");
+    CHECK(telegram.get14ByteValue("") == "Kitchen window");
+}
+
+int main() {
+    testDpt9Exhaustive();
+    testSmall();
+    testBytes();
+    testTime();
+    testString();
+
+    if (failures > 0) {
+        printf("DptTest: %d failures\n", failures);
+        return 1;
+    }
+    printf("DptTest: ok\n");
+    return 0;
+}
@@ -0,0 +1,1091 @@
+/*
+ * KnxTpUart against the simulated TP-UART
+ */
+#include "KnxTpUart.h"
+#include "KnxTpUartEmulator.h"
+
+static int failures = 0;
+
+#define CHECK(condition) \
+    if (!(condition)) { \
+        printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+        failures++; \
+    }
+
+// Polling interval of the simulated main loop
+#define LOOP_US 100
+
+static int confirmCount;
+static int failedCount;
+static unsigned long lastConfirmTime;
+
+static void txCallback(int handle, bool success, void* context) {
+    if (success) {
+        confirmCount++;
+    } else {
+        failedCount++;
+    }
+    lastConfirmTime = micros();
+}
+
+/*
+ * Runs the main loop for some time, returns how often the event occurred
+ */
+static int run(KnxTpUart* knx, unsigned long us, KnxTpUartSerialEventType event = UNKNOWN) {
+    int count = 0;
+    unsigned long end = micros() + us;
+    while (micros() < end) {
+        if (knx->serialEvent() == event) {
+            count++;
+        }
+        knx->loop();
+        hostAdvanceMicros(LOOP_US);
+    }
+    return count;
+}
+
+static void resetCounters() {
+    confirmCount = 0;
+    failedCount = 0;
+}
+
+static void testGroupWrite() {
+    KnxTpUartEmulator tpuart;
+    KnxTpUart knx(&tpuart, "1.1.10"_pa);
+    knx.setTxCallback(txCallback, 0);
+    resetCounters();
+
+    unsigned long start = micros();
+    CHECK(knx.groupWriteBool("1/2/3"_ga, true));
+    run(&knx, 100000);
+
+    CHECK(confirmCount == 1);
+    CHECK(tpuart.getSentFrameCount() == 1);
+    CHECK(tpuart.getProtocolErrorCount() == 0);
+
+    const KnxEmulatorFrame* frame = tpuart.getSentFrame(0);
+    KnxTelegramView view(frame->data, frame->length);
+    CHECK(view.isComplete());
+    CHECK(view.verifyChecksum());
+    CHECK(view.getTargetGroupAddress() == "1/2/3"_ga);
+    CHECK(view.getSourceAddress() == "1.1.10"_pa);
+    CHECK(view.getBool());
+    CHECK(frame->repetitions == 0);
+
+    printf("group write: %lu us on the bus, confirmed after %lu us\n",
+        frame->busEndTime - frame->busStartTime, lastConfirmTime - start);
+}
+
+static void testReceive() {
+    KnxTpUartEmulator tpuart;
+    KnxTpUart knx(&tpuart, "1.1.10"_pa);
+    knx.addListenGroupAddress("0/0/3"_ga);
+
+    KnxTelegram telegram;
+    telegram.setSourceAddress("1.1.20"_pa);
+    telegram.setTargetGroupAddress("0/0/3"_ga);
+    telegram.setCommand(KNX_COMMAND_WRITE);
+    telegram.set2ByteFloatValue(21.5);
+
+    tpuart.injectTelegram(&telegram);
+    CHECK(run(&knx, 50000, KNX_TELEGRAM) == 1);
+    CHECK(knx.getReceivedTelegram()->get2ByteFloatValue() == 21.5);
+    CHECK(tpuart.getAckInformationCount() == 1);
+    CHECK(tpuart.getLastAckInformation() == (TPUART_ACK_INFORMATION | TPUART_ACK_ADDRESSED));
+    CHECK(tpuart.getLateAckCount() == 0);
+
+    // Not for us
+    telegram.setTargetGroupAddress("0/0/4"_ga);
+    tpuart.injectTelegram(&telegram);
+    CHECK(run(&knx, 50000, IRRELEVANT_KNX_TELEGRAM) == 1);
+    CHECK(tpuart.getLastAckInformation() == TPUART_ACK_INFORMATION);
+
+    printf("receive: acknowledge after %lu us\n", tpuart.getMaxAckLatency());
+}
+
+static int readCount;
+static int writeCount;
+
+static void onRead(KnxTelegram* telegram, void* context) {
+    readCount++;
+    ((KnxTpUart*) context)->groupAnswer2ByteFloat(telegram->getTargetGroupAddress(), 25.28);
+}
+
+static void onWrite(KnxTelegram* telegram, void* context) {
+    writeCount++;
+    *(int*) context = telegram->get1ByteIntValue();
+}
+
+static void testGroupHandlers() {
+    KnxTpUartEmulator tpuart;
+    KnxTpUart knx(&tpuart, "1.1.10"_pa);
+    int written = 0;
+    readCount = 0;
+    writeCount = 0;
+    CHECK(knx.addGroupHandler("0/0/100"_ga, KNX_COMMAND_READ, onRead, &knx));
+    CHECK(knx.addGroupHandler("0/0/100"_ga, KNX_COMMAND_WRITE, onWrite, &written));
+    CHECK(knx.isListeningToGroupAddress("0/0/100"_ga));
+
+    KnxTelegram telegram;
+    telegram.setSourceAddress("1.1.20"_pa);
+    telegram.setTargetGroupAddress("0/0/100"_ga);
+    telegram.setCommand(KNX_COMMAND_READ);
+    tpuart.injectTelegram(&telegram);
+    telegram.setCommand(KNX_COMMAND_WRITE);
+    telegram.set1ByteIntValue(42);
+    tpuart.injectTelegram(&telegram, 10000);
+    // Answer: no handler, reported as usual
+    telegram.setCommand(KNX_COMMAND_ANSWER);
+    tpuart.injectTelegram(&telegram, 10000);
+    // and the echo of our own answer
+    CHECK(run(&knx, 200000, KNX_TELEGRAM) == 4);
+
+    CHECK(readCount == 1);
+    CHECK(writeCount == 1);
+    CHECK(written == 42);
+    CHECK(tpuart.getSentFrameCount() == 1);
+    KnxTelegramView answer(tpuart.getSentFrame(0)->data, tpuart.getSentFrame(0)->length);
+    CHECK(answer.getCommand() == KNX_COMMAND_ANSWER);
+    CHECK(answer.getTargetGroupAddress() == "0/0/100"_ga);
+}
+
+static void onNotifiedRead(KnxTelegram*, void*) {
+    readCount++;
+}
+
+static void testGroupObjects() {
+    KnxTpUartEmulator tpuart;
+    KnxTpUart knx(&tpuart, "1.1.10"_pa);
+    readCount = 0;
+    CHECK(knx.addGroupObject("0/0/7"_ga));
+    CHECK(knx.addGroupObject("0/0/8"_ga, true));
+    CHECK(knx.addGroupHandler("0/0/8"_ga, KNX_COMMAND_READ, onNotifiedRead, 0));
+
+    // No value yet: the read goes to the application
+    KnxTelegram telegram;
+    telegram.setSourceAddress("1.1.20"_pa);
+    telegram.setTargetGroupAddress("0/0/7"_ga);
+    telegram.setCommand(KNX_COMMAND_READ);
+    tpuart.injectTelegram(&telegram);
+    CHECK(run(&knx, 50000, KNX_TELEGRAM) == 1);
+    CHECK(tpuart.getSentFrameCount() == 0);
+
+    // Our own write sets the value, the next read is answered from it
+    knx.groupWrite2ByteFloat("0/0/7"_ga, 21.5);
+    run(&knx, 50000);
+    tpuart.injectTelegram(&telegram);
+    CHECK(run(&knx, 50000, KNX_GROUP_READ_ANSWERED) == 1);
+    CHECK(tpuart.getSentFrameCount() == 2);
+    KnxTelegramView answer(tpuart.getSentFrame(1)->data, tpuart.getSentFrame(1)->length);
+    CHECK(answer.getCommand() == KNX_COMMAND_ANSWER);
+    CHECK(answer.getTargetGroupAddress() == "0/0/7"_ga);
+    CHECK(answer.get2ByteFloatValue() == 21.5);
+
+    // A received write replaces it
+    telegram.setCommand(KNX_COMMAND_WRITE);
+    telegram.set2ByteFloatValue(18.0);
+    tpuart.injectTelegram(&telegram);
+    run(&knx, 50000);
+    telegram.setCommand(KNX_COMMAND_READ);
+    tpuart.injectTelegram(&telegram);
+    CHECK(run(&knx, 50000, KNX_GROUP_READ_ANSWERED) == 1);
+    CHECK(tpuart.getSentFrameCount() == 3);
+    KnxTelegramView replaced(tpuart.getSentFrame(2)->data, tpuart.getSentFrame(2)->length);
+    CHECK(replaced.get2ByteFloatValue() == 18.0);
+
+    // With notifyRead the application sees the read as well
+    knx.groupWriteBool("0/0/8"_ga, true);
+    run(&knx, 50000);
+    telegram.setTargetGroupAddress("0/0/8"_ga);
+    tpuart.injectTelegram(&telegram);
+    // and the echo of the answer
+    CHECK(run(&knx, 50000, KNX_TELEGRAM) == 2);
+    CHECK(readCount == 1);
+    CHECK(tpuart.getSentFrameCount() == 5);
+    KnxTelegramView notified(tpuart.getSentFrame(4)->data, tpuart.getSentFrame(4)->length);
+    CHECK(notified.getCommand() == KNX_COMMAND_ANSWER);
+    CHECK(notified.getBool());
+}
+
+static void onReadKeeps(KnxTelegram* telegram, void* context) {
+    readCount++;
+    ((KnxTpUart*) context)->groupAnswer1ByteInt(telegram->getTargetGroupAddress(), 7);
+    // Answering does not touch the request
+    CHECK(telegram->getCommand() == KNX_COMMAND_READ);
+    CHECK(((KnxTpUart*) context)->getReceivedTelegram()->getCommand() == KNX_COMMAND_READ);
+}
+
+/*
+ * Runs the main loop until the event occurs, false if it didn't in time
+ */
+static bool runUntil(KnxTpUart* knx, unsigned long us, KnxTpUartSerialEventType event) {
+    unsigned long end = micros() + us;
+    while (micros() < end) {
+        KnxTpUartSerialEventType eventType = knx->serialEvent();
+        knx->loop();
+        hostAdvanceMicros(LOOP_US);
+        if (eventType == event) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void testTelegramPool() {
+    KnxTpUartEmulator tpuart;
+    KnxTpUart knx(&tpuart, "1.1.10"_pa);
+    readCount = 0;
+    CHECK(knx.addGroupHandler("0/0/9"_ga, KNX_COMMAND_READ, onReadKeeps, &knx));
+    CHECK(knx.getFreeTelegramCount() == TPUART_TELEGRAM_POOL_SIZE - 1);
+
+    KnxTelegram telegram;
+    telegram.setSourceAddress("1.1.20"_pa);
+    telegram.setTargetGroupAddress("0/0/9"_ga);
+    telegram.setCommand(KNX_COMMAND_READ);
+    tpuart.injectTelegram(&telegram);
+    run(&knx, 50000);
+    CHECK(readCount == 1);
+    CHECK(tpuart.getSentFrameCount() == 1);
+    CHECK(knx.getFreeTelegramCount() == TPUART_TELEGRAM_POOL_SIZE - 1);
+
+    // A taken telegram is not overwritten by the next one
+    telegram.setCommand(KNX_COMMAND_WRITE);
+    telegram.set1ByteIntValue(1);
+    tpuart.injectTelegram(&telegram);
+    telegram.set1ByteIntValue(2);
+    tpuart.injectTelegram(&telegram, 10000);
+    CHECK(runUntil(&knx, 50000, KNX_TELEGRAM));
+    KnxTelegram* taken = knx.takeReceivedTelegram();
+    CHECK(taken != 0);
+    CHECK(runUntil(&knx, 50000, KNX_TELEGRAM));
+    CHECK(taken->get1ByteIntValue() == 1);
+    CHECK(knx.getReceivedTelegram()->get1ByteIntValue() == 2);
+    knx.releaseTelegram(taken);
+    CHECK(knx.getFreeTelegramCount() == TPUART_TELEGRAM_POOL_SIZE - 1);
+
+    // Telegrams the application keeps are missing for sending
+    KnxTelegram* kept[TPUART_TELEGRAM_POOL_SIZE];
+    int keptCount = 0;
+    while ((kept[keptCount] = knx.takeReceivedTelegram()) != 0) {
+        keptCount++;
+    }
+    CHECK(keptCount == TPUART_TELEGRAM_POOL_SIZE - 1);
+    CHECK(knx.getTelegramPoolExhaustedCount() == 1);
+    CHECK(!knx.groupWriteBool("0/0/9"_ga, true));
+    CHECK(knx.sendTelegram(&telegram) == -1);
+    CHECK(knx.getTelegramPoolExhaustedCount() == 3);
+
+    for (int i = 0; i < keptCount; i++) {
+        knx.releaseTelegram(kept[i]);
+    }
+    // Released twice, or not from the pool: ignored
+    knx.releaseTelegram(kept[0]);
+    knx.releaseTelegram(&telegram);
+    CHECK(knx.getFreeTelegramCount() == TPUART_TELEGRAM_POOL_SIZE - 1);
+    CHECK(knx.groupWriteBool("0/0/9"_ga, true));
+    CHECK(knx.getFreeTelegramCount() == TPUART_TELEGRAM_POOL_SIZE - 2);
+    run(&knx, 50000);
+    CHECK(knx.getFreeTelegramCount() == TPUART_TELEGRAM_POOL_SIZE - 1);
+}
+
+static void testExtendedFrames() {
+    KnxTpUartEmulator tpuart;
+    KnxTpUart knx(&tpuart, "1.1.10"_pa);
+    knx.addListenGroupAddress("0/0/5"_ga);
+    byte data[200];
+    for (int i = 0; i < (int) sizeof(data); i++) {
+        data[i] = i;
+    }
+
+    // Beyond index 63 with U_L_DataOffset, the standard pool is not touched
+    KnxExtendedTelegram* telegram = knx.allocateExtendedTelegram();
+    CHECK(telegram != 0);
+    telegram->setSourceAddress("1.1.10"_pa);
+    telegram->setTargetIndividualAddress("1.1.30"_pa);
+    telegram->setCommand(KNX_COMMAND_MEM_WRITE);
+    telegram->setData(data, sizeof(data));
+    telegram->createChecksum();
+    CHECK(telegram->getTotalLength() == KNX_EXTENDED_TELEGRAM_HEADER_SIZE + 2 + (int) sizeof(data) + 1);
+    CHECK(knx.sendExtendedTelegram(telegram) >= 0);
+    // 420 bytes over the serial line, 210 bytes on the bus
+    run(&knx, 1000000);
+    CHECK(tpuart.getProtocolErrorCount() == 0);
+    CHECK(tpuart.getSentFrameCount() == 1);
+    const KnxEmulatorFrame* sent = tpuart.getSentFrame(0);
+    CHECK(sent->confirmed);
+    CHECK(sent->length == KNX_EXTENDED_TELEGRAM_HEADER_SIZE + 2 + (int) sizeof(data) + 1);
+    KnxTelegramView view(sent->data, sent->length);
+    CHECK(view.isExtended());
+    CHECK(view.verifyChecksum());
+    CHECK(view.getTargetIndividualAddress() == "1.1.30"_pa);
+    CHECK(sent->data[9 + 150] == 150);
+    CHECK(knx.getFreeExtendedTelegramCount() == TPUART_EXTENDED_TELEGRAM_POOL_SIZE);
+    CHECK(knx.getFreeTelegramCount() == TPUART_TELEGRAM_POOL_SIZE - 1);
+    printf("extended frame: %d bytes in %lu us on the bus, standard frames need %d\n", (int) sizeof(data),
+        sent->busEndTime - sent->busStartTime, ((int) sizeof(data) + 11) / 12);
+
+    // Received into the extended class, taken over like standard telegrams
+    KnxExtendedTelegram incoming;
+    incoming.setSourceAddress("1.1.20"_pa);
+    incoming.setTargetGroupAddress("0/0/5"_ga);
+    incoming.setCommand(KNX_COMMAND_WRITE);
+    incoming.setData(data, 100);
+    tpuart.injectTelegram(&incoming);
+    CHECK(runUntil(&knx, 300000, KNX_EXTENDED_TELEGRAM));
+    CHECK(tpuart.getLastAckInformation() == (TPUART_ACK_INFORMATION | TPUART_ACK_ADDRESSED));
+    KnxExtendedTelegram* taken = knx.takeReceivedExtendedTelegram();
+    CHECK(taken != 0 && taken->getView().getTargetGroupAddress() == "0/0/5"_ga);
+    CHECK(taken != 0 && taken->getPayloadLength() == 102 && taken->getBufferByte(9 + 99) == 99);
+    CHECK(knx.getReceivedExtendedTelegram() == 0);
+
+    // Without a free extended telegram the sender is told to repeat it
+    KnxExtendedTelegram* kept[TPUART_EXTENDED_TELEGRAM_POOL_SIZE];
+    int keptCount = 0;
+    while ((kept[keptCount] = knx.allocateExtendedTelegram()) != 0) {
+        keptCount++;
+    }
+    tpuart.injectTelegram(&incoming);
+    CHECK(!runUntil(&knx, 300000, KNX_EXTENDED_TELEGRAM));
+    CHECK(tpuart.getLastAckInformation() == (TPUART_ACK_INFORMATION | TPUART_ACK_ADDRESSED | TPUART_ACK_BUSY));
+    CHECK(knx.getTelegramPoolExhaustedCount() > 0);
+
+    knx.releaseTelegram(taken);
+    for (int i = 0; i < keptCount; i++) {
+        knx.releaseTelegram(kept[i]);
+    }
+    CHECK(knx.getFreeExtendedTelegramCount() == TPUART_EXTENDED_TELEGRAM_POOL_SIZE);
+    CHECK(knx.getFreeTelegramCount() == TPUART_TELEGRAM_POOL_SIZE - 1);
+
+    // Length 0xFF, one byte more than an extended telegram holds: refused and
+    // skipped, the telegram after the one it was received into is untouched
+    KnxExtendedTelegram* first = knx.allocateExtendedTelegram();
+    KnxExtendedTelegram* second = knx.allocateExtendedTelegram();
+    KnxExtendedTelegram* neighbour = first < second ? second : first;
+    knx.releaseTelegram(first < second ? first : second);
+    byte escaped[KNX_EXTENDED_TELEGRAM_HEADER_SIZE + 256 + 1];
+    for (int i = 0; i < (int) sizeof(escaped); i++) {
+        escaped[i] = i < KNX_EXTENDED_TELEGRAM_HEADER_SIZE ? incoming.getBufferByte(i) : 0x55;
+    }
+    escaped[3] = 21;    // from 1.1.21, 1.1.20 looks like a control byte
+    escaped[6] = 0xFF;
+    tpuart.injectFrame(escaped, sizeof(escaped));
+    tpuart.injectTelegram(&incoming);
+    CHECK(runUntil(&knx, 400000, KNX_TELEGRAM_ERROR));
+    CHECK(tpuart.getLastAckInformation() == (TPUART_ACK_INFORMATION | TPUART_ACK_ADDRESSED | TPUART_ACK_NACK));
+    CHECK(neighbour->getBufferByte(0) == 0x3C);
+    // Still in step with the bus
+    CHECK(runUntil(&knx, 300000, KNX_EXTENDED_TELEGRAM));
+    knx.releaseTelegram(knx.takeReceivedExtendedTelegram());
+    knx.releaseTelegram(neighbour);
+    CHECK(knx.getFreeExtendedTelegramCount() == TPUART_EXTENDED_TELEGRAM_POOL_SIZE);
+
+    // A standard telegram with the frame type bit cleared claims up to 263
+    // bytes: no checksum is written or read past its buffer, it isn't sent
+    KnxTelegram standard;
+    standard.setBufferByte(0, 0x3C);
+    standard.setBufferByte(6, 0xFE);
+    standard.setBufferByte(22, 0x77);
+    standard.createChecksum();
+    CHECK(standard.getBufferByte(22) == 0x77);
+    CHECK(standard.getChecksum() == -1 && standard.getView().calculateChecksum() == -1);
+    CHECK(!standard.verifyChecksum());
+    int sentCount = tpuart.getSentFrameCount();
+    CHECK(knx.sendTelegram(&standard) == -1);
+    run(&knx, 50000);
+    CHECK(tpuart.getSentFrameCount() == sentCount);
+    CHECK(knx.getFreeTelegramCount() == TPUART_TELEGRAM_POOL_SIZE - 1);
+}
+
+static void testNotAcknowledged() {
+    KnxTpUartEmulator tpuart;
+    KnxTpUart knx(&tpuart, "1.1.10"_pa);
+    knx.setTxCallback(txCallback, 0);
+    resetCounters();
+
+    tpuart.setAckResponse(EMULATOR_NACK);
+    knx.groupWrite1ByteInt("1/2/3"_ga, 42);
+    run(&knx, 1000000);
+
+    // Given up after the last attempt, reported once
+    CHECK(failedCount == 1);
+    CHECK(tpuart.getSentFrameCount() == TPUART_TX_ATTEMPTS);
+    for (int i = 0; i < tpuart.getSentFrameCount(); i++) {
+        CHECK(tpuart.getSentFrame(i)->repetitions == TPUART_EMULATOR_REPETITIONS);
+        CHECK(!tpuart.getSentFrame(i)->confirmed);
+        // Retries are sent with the repeat flag
+        KnxTelegramView sent(tpuart.getSentFrame(i)->data);
+        CHECK(sent.isRepeated() == (i > 0));
+        CHECK(sent.verifyChecksum());
+    }
+    const KnxTxStatistics* statistics = knx.getTxStatistics("1/2/3"_ga);
+    CHECK(statistics != 0 && statistics->failed == 1 && statistics->retries == TPUART_TX_ATTEMPTS - 1);
+    CHECK(knx.getTxStatistics()->failed == 1);
+}
+
+static void testRetry() {
+    KnxTpUartEmulator tpuart;
+    KnxTpUart knx(&tpuart, "1.1.10"_pa);
+    knx.setTxCallback(txCallback, 0);
+    resetCounters();
+
+    // The first attempt is not acknowledged, with all repetitions of the TPUART
+    tpuart.setAckResponse(EMULATOR_NACK, TPUART_EMULATOR_REPETITIONS + 1);
+    knx.groupWrite1ByteInt("1/2/3"_ga, 42);
+    knx.groupWrite1ByteInt("1/2/3"_ga, 43);
+    run(&knx, 1000000);
+
+    CHECK(confirmCount == 2);
+    CHECK(failedCount == 0);
+    CHECK(tpuart.getSentFrameCount() == 3);
+    CHECK(tpuart.getSentFrame(1)->confirmed);
+    // The retry waited a while, and the next value stays behind it
+    CHECK(tpuart.getSentFrame(1)->busStartTime - tpuart.getSentFrame(0)->busEndTime >= TPUART_TX_RETRY_DELAY_MS * 1000UL);
+    CHECK(KnxTelegramView(tpuart.getSentFrame(1)->data).get1ByteIntValue() == 42);
+    CHECK(KnxTelegramView(tpuart.getSentFrame(2)->data).get1ByteIntValue() == 43);
+
+    const KnxTxStatistics* statistics = knx.getTxStatistics("1/2/3"_ga);
+    CHECK(statistics != 0 && statistics->confirmed == 2 && statistics->retries == 1 && statistics->failed == 0);
+    CHECK(knx.getTxStatistics("1/2/4"_ga) == 0);
+
+    // Without retries
+    resetCounters();
+    knx.setTxAttempts(1);
+    tpuart.setAckResponse(EMULATOR_NACK, TPUART_EMULATOR_REPETITIONS + 1);
+    knx.groupWrite1ByteInt("1/2/3"_ga, 44);
+    run(&knx, 1000000);
+    CHECK(failedCount == 1);
+    CHECK(tpuart.getSentFrameCount() == 4);
+}
+
+static void testErrors() {
+    KnxTpUartEmulator tpuart;
+    KnxTpUart knx(&tpuart, "1.1.10"_pa);
+    knx.setTxCallback(txCallback, 0);
+    resetCounters();
+
+    // Lost confirmation: the queue must not get stuck, the telegram is sent again
+    tpuart.loseConfirms(1);
+    knx.groupWriteBool("1/2/3"_ga, true);
+    knx.groupWriteBool("1/2/3"_ga, false);
+    run(&knx, 1000000);
+    CHECK(failedCount == 0);
+    CHECK(confirmCount == 2);
+    CHECK(tpuart.getSentFrameCount() == 3);
+    CHECK(knx.getTxQueueCount() == 0);
+
+    tpuart.injectReset();
+    CHECK(run(&knx, 10000, TPUART_RESET_INDICATION) == 1);
+
+    const byte noise[] = {0x55, 0xAA};
+    tpuart.injectNoise(noise, sizeof(noise));
+    CHECK(run(&knx, 10000, UNKNOWN) >= 2);
+
+    // Truncated frame, the next one must still be received
+    knx.addListenGroupAddress("0/0/3"_ga);
+    KnxTelegram telegram;
+    telegram.setTargetGroupAddress("0/0/3"_ga);
+    telegram.createChecksum();
+    byte frame[MAX_KNX_TELEGRAM_SIZE];
+    for (int i = 0; i < telegram.getTotalLength(); i++) {
+        frame[i] = telegram.getBufferByte(i);
+    }
+    tpuart.injectFrame(frame, 5);
+    tpuart.injectTelegram(&telegram, 50000);
+    CHECK(run(&knx, 100000, KNX_TELEGRAM) == 1);
+}
+
+/*
+ * Runs the main loop, counting telegrams and error frames
+ */
+static void runCounting(KnxTpUart* knx, unsigned long us, int* telegrams, int* errors) {
+    *telegrams = 0;
+    *errors = 0;
+    unsigned long end = micros() + us;
+    while (micros() < end) {
+        KnxTpUartSerialEventType event = knx->serialEvent();
+        if (event == KNX_TELEGRAM) {
+            (*telegrams)++;
+        } else if (event == KNX_TELEGRAM_ERROR) {
+            (*errors)++;
+        }
+        knx->loop();
+        hostAdvanceMicros(LOOP_US);
+    }
+}
+
+static void testResync() {
+    KnxTpUartEmulator tpuart;
+    KnxTpUart knx(&tpuart, "1.1.10"_pa);
+    knx.addListenGroupAddress("0/0/3"_ga);
+    int telegrams;
+    int errors;
+
+    KnxTelegram telegram;
+    telegram.setSourceAddress("1.1.20"_pa);
+    telegram.setTargetGroupAddress("0/0/3"_ga);
+    telegram.setCommand(KNX_COMMAND_WRITE);
+    telegram.set2ByteFloatValue(21.5);
+    telegram.createChecksum();
+    byte frame[MAX_KNX_TELEGRAM_SIZE];
+    int length = telegram.getTotalLength();
+    for (int i = 0; i < length; i++) {
+        frame[i] = telegram.getBufferByte(i);
+    }
+
+    // Wrong checksum: reported as error, not as telegram
+    frame[length - 1] ^= 0x01;
+    tpuart.injectFrame(frame, length);
+    runCounting(&knx, 50000, &telegrams, &errors);
+    CHECK(telegrams == 0);
+    CHECK(errors == 1);
+    frame[length - 1] ^= 0x01;
+
+    // A glitch that looks like a control byte right before a telegram:
+    // the telegram is found in the bytes of the rejected frame
+    const byte glitch[] = {0xBC};
+    tpuart.injectNoise(glitch, sizeof(glitch));
+    tpuart.injectFrame(frame, length);
+    tpuart.injectFrame(frame, length);
+    runCounting(&knx, 100000, &telegrams, &errors);
+    CHECK(errors == 1);
+    CHECK(telegrams == 2);
+    CHECK(knx.getReceivedTelegram()->get2ByteFloatValue() == 21.5);
+
+    // Garbage with two false control bytes right before two telegrams
+    const byte garbage[] = {0xB0, 0x11, 0xBC, 0x22};
+    tpuart.injectNoise(garbage, sizeof(garbage));
+    tpuart.injectFrame(frame, length);
+    tpuart.injectFrame(frame, length);
+    runCounting(&knx, 100000, &telegrams, &errors);
+    CHECK(telegrams == 2);
+
+    // A frame cut off by a gap, with a false control byte in it: its bytes
+    // are replayed up to the gap. A telegram starting in the bytes replayed
+    // after the next error continues in the received ones, not cut off there.
+    byte cut[] = {frame[0], frame[1], 0xBC, frame[3]};
+    tpuart.injectFrame(cut, sizeof(cut));
+    runCounting(&knx, 50000, &telegrams, &errors);
+    CHECK(telegrams == 0);
+    tpuart.injectNoise(glitch, sizeof(glitch));
+    tpuart.injectFrame(frame, length);
+    tpuart.injectFrame(frame, length);
+    runCounting(&knx, 100000, &telegrams, &errors);
+    CHECK(errors == 1);
+    CHECK(telegrams == 2);
+}
+
+static void testMonitor() {
+    KnxTpUartEmulator tpuart;
+    KnxTpUart knx(&tpuart, "1.1.10"_pa);
+    KnxMonitorBuffer monitor;
+    knx.addListenGroupAddress("0/0/3"_ga);
+    knx.setMonitorMode(&monitor);
+    CHECK(tpuart.isBusmonActive());
+
+    KnxTelegram telegram;
+    telegram.setSourceAddress("1.1.20"_pa);
+    telegram.setTargetGroupAddress("0/0/3"_ga);
+    telegram.setCommand(KNX_COMMAND_WRITE);
+    telegram.set1ByteIntValue(42);
+    tpuart.injectTelegram(&telegram);
+    telegram.setTargetGroupAddress("0/0/4"_ga);
+    tpuart.injectTelegram(&telegram);
+
+    // Wrong checksum
+    telegram.createChecksum();
+    byte frame[MAX_KNX_TELEGRAM_SIZE];
+    for (int i = 0; i < telegram.getTotalLength(); i++) {
+        frame[i] = telegram.getBufferByte(i);
+    }
+    frame[telegram.getTotalLength() - 1] ^= 0xFF;
+    tpuart.injectFrame(frame, telegram.getTotalLength());
+
+    // Frames and the acknowledges of the receivers
+    CHECK(run(&knx, 200000, KNX_MONITOR_FRAME) == 6);
+    CHECK(tpuart.getAckInformationCount() == 0);
+    CHECK(tpuart.getProtocolErrorCount() == 0);
+
+    KnxMonitorFrame frames[TPUART_MONITOR_BUFFER_SIZE];
+    CHECK(monitor.read(frames, TPUART_MONITOR_BUFFER_SIZE) == 6);
+    CHECK(frames[0].flags == 0);
+    CHECK(frames[0].getView().getTargetGroupAddress() == "0/0/3"_ga);
+    CHECK(frames[0].getView().get1ByteIntValue() == 42);
+    CHECK(frames[1].flags == KNX_MONITOR_ACK && frames[1].data[0] == KNX_BUS_ACK);
+    CHECK(frames[1].time > frames[0].time);
+    CHECK(frames[2].getView().getTargetGroupAddress() == "0/0/4"_ga);
+    CHECK(frames[4].flags == KNX_MONITOR_CHECKSUM_ERROR);
+
+    // Extended frames are stored in part, their checksum is checked over all bytes
+    KnxExtendedTelegram extended;
+    extended.setSourceAddress("1.1.21"_pa);     // 1.1.20 looks like a control byte
+    extended.setTargetGroupAddress("0/0/3"_ga);
+    extended.setCommand(KNX_COMMAND_WRITE);
+    byte data[60] = {0};
+    extended.setData(data, sizeof(data));
+    extended.createChecksum();
+    tpuart.injectTelegram(&extended);
+    byte extendedFrame[MAX_KNX_EXTENDED_TELEGRAM_SIZE];
+    int extendedLength = extended.getTotalLength();
+    for (int i = 0; i < extendedLength; i++) {
+        extendedFrame[i] = extended.getBufferByte(i);
+    }
+    extendedFrame[40] ^= 0x01;
+    tpuart.injectFrame(extendedFrame, extendedLength);
+    CHECK(run(&knx, 400000, KNX_MONITOR_FRAME) == 4);
+    CHECK(monitor.read(frames, TPUART_MONITOR_BUFFER_SIZE) == 4);
+    CHECK(frames[0].flags == KNX_MONITOR_PARTIAL && frames[0].length == MAX_KNX_TELEGRAM_SIZE);
+    CHECK(frames[0].getView().getTargetGroupAddress() == "0/0/3"_ga);
+    CHECK(frames[2].flags == (KNX_MONITOR_PARTIAL | KNX_MONITOR_CHECKSUM_ERROR));
+
+    // Sending waits for the end of the mode
+    knx.groupWriteBool("1/2/3"_ga, true);
+    run(&knx, 50000);
+    CHECK(tpuart.getSentFrameCount() == 0);
+
+    // Not drained: nothing is overwritten, the loss is flagged
+    for (int i = 0; i < TPUART_MONITOR_BUFFER_SIZE; i++) {
+        tpuart.injectTelegram(&telegram);
+    }
+    run(&knx, 500000);
+    CHECK(monitor.getCount() == TPUART_MONITOR_BUFFER_SIZE);
+    CHECK(monitor.getLostCount() == TPUART_MONITOR_BUFFER_SIZE);
+    // Drained in pieces up to the end of the array
+    const KnxMonitorFrame* stored;
+    int drained = 0;
+    int count;
+    while ((count = monitor.peek(&stored)) > 0) {
+        CHECK(stored[0].flags == 0 || stored[0].flags == KNX_MONITOR_ACK);
+        drained += count;
+        monitor.release(count);
+    }
+    CHECK(drained == TPUART_MONITOR_BUFFER_SIZE);
+    tpuart.injectTelegram(&telegram);
+    run(&knx, 50000);
+    CHECK(monitor.read(frames, 1) == 1);
+    CHECK(frames[0].flags & KNX_MONITOR_OVERFLOW);
+
+    knx.setMonitorMode(0);
+    CHECK(run(&knx, 10000, TPUART_RESET_INDICATION) == 1);
+    CHECK(!tpuart.isBusmonActive());
+    run(&knx, 100000);
+    // Handed to the TPUART before the reset indication arrived, so it counts
+    // as lost and is sent again
+    CHECK(tpuart.getSentFrameCount() == 2);
+    CHECK(tpuart.getSentFrame(1)->confirmed);
+}
+
+static void testStartupBurst() {
+    KnxTpUartEmulator tpuart;
+    KnxTpUart knx(&tpuart, "1.1.10"_pa);
+    knx.setTxCallback(txCallback, 0);
+    resetCounters();
+
+    // 200 cyclic objects all want to send at once
+    int queued = 0;
+    unsigned long busiest = 0;
+    unsigned long lastBusy = 0;
+    for (int second = 0; second < 40; second++) {
+        unsigned long end = micros() + 1000000UL;
+        while (micros() < end) {
+            while (queued < 200 && knx.groupWrite2ByteFloat(KnxGroupAddress(1, 0, queued), 20.0)) {
+                queued++;
+            }
+            knx.serialEvent();
+            knx.loop();
+            hostAdvanceMicros(LOOP_US);
+        }
+        unsigned long busy = tpuart.getBusBusyMicros() - lastBusy;
+        lastBusy = tpuart.getBusBusyMicros();
+        if (busy > busiest) {
+            busiest = busy;
+        }
+    }
+
+    CHECK(confirmCount == 200);
+    CHECK(failedCount == 0);
+    // Budget of normal priority, the window slides in steps
+    CHECK(busiest <= 1000000UL * (TPUART_TX_BUDGET_NORMAL + 10) / 100);
+    printf("startup burst: busiest second %lu%% bus load\n", busiest / 10000UL);
+}
+
+static void testBusLoadEstimate() {
+    KnxTpUartEmulator tpuart;
+    KnxTpUart knx(&tpuart, "1.1.10"_pa);
+    resetCounters();
+
+    // Other devices keep the bus busy for 1.8 s, 23 ms per frame
+    KnxTelegram telegram;
+    telegram.setSourceAddress("1.1.20"_pa);
+    telegram.setTargetGroupAddress("1/1/1"_ga);
+    telegram.setCommand(KNX_COMMAND_WRITE);
+    telegram.set2ByteFloatValue(20.0);
+    for (int i = 0; i < 80; i++) {
+        tpuart.injectTelegram(&telegram);
+    }
+    run(&knx, 1700000);
+    CHECK(knx.getBusLoad() >= 90);
+
+    // Normal priority waits, high priority goes
+    knx.setTxCallback(txCallback, 0);
+    knx.groupWriteBool("1/2/3"_ga, true);
+    run(&knx, 50000);
+    CHECK(confirmCount == 0);
+    KnxTelegram high;
+    high.setSourceAddress("1.1.10"_pa);
+    high.setTargetGroupAddress("1/2/4"_ga);
+    high.setPriority(KNX_PRIORITY_HIGH);
+    high.setCommand(KNX_COMMAND_WRITE);
+    high.setPayloadLength(2);
+    high.setFirstDataByte(1);
+    high.createChecksum();
+    knx.sendTelegram(&high, txCallback, 0);
+    run(&knx, 300000);
+    CHECK(confirmCount == 1);
+    CHECK(tpuart.getSentFrame(0)->data[4] == 4);
+
+    // and gets its turn once the bus is quiet again
+    run(&knx, 2000000);
+    CHECK(confirmCount == 2);
+    CHECK(knx.getBusLoad() < 10);
+}
+
+static void testCoalescing() {
+    KnxTpUartEmulator tpuart;
+    KnxTpUart knx(&tpuart, "1.1.10"_pa);
+    knx.setTxCoalescing(true);
+
+    // A slider: the first value goes out, the others replace each other
+    for (int i = 0; i <= 100; i++) {
+        CHECK(knx.groupWrite1ByteInt("1/2/3"_ga, i));
+    }
+    CHECK(knx.getTxQueueCount() == 2);
+    run(&knx, 200000);
+    CHECK(tpuart.getSentFrameCount() == 2);
+    CHECK(KnxTelegramView(tpuart.getSentFrame(1)->data).get1ByteIntValue() == 100);
+}
+
+static void testPrepared() {
+    KnxTpUartEmulator tpuart;
+    KnxTpUart knx(&tpuart, "1.1.10"_pa);
+    typedef Dpt<9, 1> Temperature;
+
+    KnxPreparedTelegram prepared;
+    knx.prepareGroupTelegram<Temperature>(&prepared, KNX_COMMAND_WRITE, "0/0/3"_ga);
+    CHECK(prepared.setValue<Temperature>(21.5));
+    CHECK(knx.sendPrepared(&prepared));
+    run(&knx, 100000);
+    CHECK(tpuart.getSentFrameCount() == 1);
+    KnxTelegramView sent(tpuart.getSentFrame(0)->data);
+    CHECK(sent.verifyChecksum() && sent.get2ByteFloatValue() == 21.5);
+
+    // Prepared for one data byte less: refused, the checksum stays intact
+    knx.prepareGroupTelegram(&prepared, KNX_COMMAND_WRITE, "0/0/3"_ga, 2);
+    CHECK(!prepared.set2ByteFloatValue(21.5));
+    CHECK(!prepared.setDataByte(prepared.getTelegram()->getTotalLength() - 1, 0));
+    CHECK(prepared.setBool(true));
+    CHECK(prepared.getTelegram()->verifyChecksum());
+}
+
+static void testSendFilter() {
+    KnxTpUartEmulator tpuart;
+    KnxTpUart knx(&tpuart, "1.1.10"_pa);
+    typedef Dpt<9, 1> Temperature;
+    CHECK(knx.setSendFilter<Temperature>("0/0/3"_ga, 500, 0.5));
+
+    KnxTelegram telegram;
+    telegram.setSourceAddress("1.1.10"_pa);
+    telegram.setTargetGroupAddress("0/0/3"_ga);
+    telegram.setCommand(KNX_COMMAND_WRITE);
+    telegram.setValue<Temperature>(20.0);
+    telegram.createChecksum();
+    CHECK(knx.sendTelegram(&telegram) != TPUART_TX_COALESCED);
+    run(&knx, 100000);
+
+    // Below the threshold
+    CHECK(knx.groupWrite2ByteFloat("0/0/3"_ga, 20.2));
+    run(&knx, 100000);
+    // Too early, held in its telegram from the pool and replaced by the next one
+    int free = knx.getFreeTelegramCount();
+    CHECK(knx.groupWrite2ByteFloat("0/0/3"_ga, 21.0));
+    run(&knx, 100000);
+    CHECK(knx.getFreeTelegramCount() == free - 1);
+    CHECK(knx.groupWrite2ByteFloat("0/0/3"_ga, 21.5));
+    CHECK(knx.getFreeTelegramCount() == free - 1);
+    CHECK(tpuart.getSentFrameCount() == 1);
+    run(&knx, 400000);
+    CHECK(tpuart.getSentFrameCount() == 2);
+    CHECK(KnxTelegramView(tpuart.getSentFrame(1)->data).get2ByteFloatValue() == 21.5);
+    CHECK(knx.getFreeTelegramCount() == free);
+
+    // A held one is dropped with a write back near the value sent
+    CHECK(knx.groupWrite2ByteFloat("0/0/3"_ga, 23.0));
+    CHECK(knx.getFreeTelegramCount() == free - 1);
+    CHECK(knx.groupWrite2ByteFloat("0/0/3"_ga, 21.5));
+    CHECK(knx.getFreeTelegramCount() == free);
+    run(&knx, 600000);
+    CHECK(tpuart.getSentFrameCount() == 2);
+
+    // Compared with the value sent last
+    run(&knx, 1000000);
+    CHECK(knx.groupWrite2ByteFloat("0/0/3"_ga, 21.6));
+    run(&knx, 1000000);
+    CHECK(tpuart.getSentFrameCount() == 2);
+
+    // Other addresses are not filtered
+    CHECK(knx.groupWrite2ByteFloat("0/0/4"_ga, 21.6));
+    run(&knx, 100000);
+    CHECK(tpuart.getSentFrameCount() == 3);
+}
+
+/*
+ * The receive interrupt: moves the bytes from the TPUART into the ring as
+ * they arrive, while the main loop may be busy
+ */
+static void runInterrupt(KnxTpUartEmulator* tpuart, KnxRxRing* ring, unsigned long us) {
+    unsigned long end = micros() + us;
+    while (micros() < end) {
+        ring->fill(tpuart);
+        hostAdvanceMicros(LOOP_US);
+    }
+}
+
+static void testRxRing() {
+    KnxTpUartEmulator tpuart;
+    KnxTpUart knx(&tpuart, "1.1.10"_pa);
+    KnxRxRing ring;
+    knx.setRxRing(&ring);
+    knx.addListenGroupAddress("0/0/3"_ga);
+
+    KnxTelegram telegram;
+    telegram.setSourceAddress("1.1.20"_pa);
+    telegram.setTargetGroupAddress("0/0/3"_ga);
+    telegram.setCommand(KNX_COMMAND_WRITE);
+    telegram.set2ByteFloatValue(21.5);
+    telegram.createChecksum();
+    byte frame[MAX_KNX_TELEGRAM_SIZE];
+    int length = telegram.getTotalLength();
+    for (int i = 0; i < length; i++) {
+        frame[i] = telegram.getBufferByte(i);
+    }
+
+    // The main loop stalls for 100 ms while the bus is fully loaded
+    for (int i = 0; i < 4; i++) {
+        tpuart.injectFrame(frame, length);
+    }
+    runInterrupt(&tpuart, &ring, 100000);
+    CHECK(ring.getCount() == 4 * length);
+
+    int telegrams;
+    int errors;
+    runCounting(&knx, 10000, &telegrams, &errors);
+    CHECK(telegrams == 4);
+    CHECK(errors == 0);
+    CHECK(ring.getCount() == 0);
+    CHECK(ring.getLostCount() == 0);
+    // Too late for the acknowledges, none is sent after the fact
+    CHECK(tpuart.getAckInformationCount() == 0);
+
+    // A truncated frame right before a telegram: read back to back, the
+    // silence between them is in the times of the bytes
+    tpuart.injectFrame(frame, 5);
+    tpuart.injectFrame(frame, length, 5000);
+    runInterrupt(&tpuart, &ring, 50000);
+    runCounting(&knx, 10000, &telegrams, &errors);
+    CHECK(errors == 1);
+    CHECK(telegrams == 1);
+
+    // A corrupted frame doesn't end reading from the ring
+    byte corrupted[MAX_KNX_TELEGRAM_SIZE];
+    for (int i = 0; i < length; i++) {
+        corrupted[i] = frame[i];
+    }
+    corrupted[length - 1] ^= 0xFF;
+    tpuart.injectFrame(corrupted, length);
+    tpuart.injectFrame(frame, length);
+    runInterrupt(&tpuart, &ring, 50000);
+    runCounting(&knx, 10000, &telegrams, &errors);
+    CHECK(errors == 1);
+    CHECK(telegrams == 1);
+    CHECK(ring.getCount() == 0);
+
+    // Without stall the header is still acknowledged in time
+    tpuart.injectFrame(frame, length);
+    unsigned long end = micros() + 50000;
+    while (micros() < end) {
+        ring.fill(&tpuart);
+        knx.serialEvent();
+        hostAdvanceMicros(LOOP_US);
+    }
+    CHECK(tpuart.getAckInformationCount() == 1);
+    CHECK(tpuart.getLateAckCount() == 0);
+
+    // Stalled for a wrap of the byte times: the header looks just received
+    // by its time, but is not acknowledged
+    tpuart.injectFrame(frame, length);
+    while (ring.getCount() < KNX_TELEGRAM_HEADER_SIZE) {
+        runInterrupt(&tpuart, &ring, LOOP_US);
+    }
+    hostAdvanceMicros(TPUART_RX_RING_TIME_WRAP_US);
+    telegrams = 0;
+    end = micros() + 50000;
+    while (micros() < end) {
+        ring.fill(&tpuart);
+        if (knx.serialEvent() == KNX_TELEGRAM) {
+            telegrams++;
+        }
+        hostAdvanceMicros(LOOP_US);
+    }
+    CHECK(telegrams == 1);
+    CHECK(tpuart.getAckInformationCount() == 1);
+
+    // Full ring: bytes are dropped and counted, the rest is resynchronized
+    for (int i = 0; i < 12; i++) {
+        tpuart.injectFrame(frame, length);
+    }
+    runInterrupt(&tpuart, &ring, 300000);
+    CHECK(ring.getLostCount() == (unsigned long) (12 * length - TPUART_RX_RING_SIZE));
+    runCounting(&knx, 10000, &telegrams, &errors);
+    CHECK(telegrams == TPUART_RX_RING_SIZE / length);
+}
+
+// Point-to-point telegram to 1.1.10 without APDU, e.g. a control telegram
+static KnxTelegram transportTelegram(KnxIndividualAddress source, KnxCommunicationType type, int sequence) {
+    KnxTelegram telegram;
+    telegram.setSourceAddress(source);
+    telegram.setTargetIndividualAddress("1.1.10"_pa);
+    telegram.setPayloadLength(1);
+    telegram.setCommunicationType(type);
+    telegram.setSequenceNumber(sequence);
+    return telegram;
+}
+
+static KnxTelegramView lastSentFrame(KnxTpUartEmulator* tpuart) {
+    return KnxTelegramView(tpuart->getSentFrame(tpuart->getSentFrameCount() - 1)->data);
+}
+
+static void testTransportConnection() {
+    KnxTpUartEmulator tpuart;
+    KnxTpUart knx(&tpuart, "1.1.10"_pa);
+    KnxTransportConnection* connection = knx.getTransportConnection();
+
+    // T_Connect of the remote device opens the connection, not reported
+    KnxTelegram control = transportTelegram("1.1.20"_pa, KNX_COMM_UCD, 0);
+    control.setControlData(KNX_CONTROLDATA_CONNECT);
+    tpuart.injectTelegram(&control);
+    CHECK(run(&knx, 50000, KNX_TELEGRAM) == 0);
+    CHECK(connection->isOpen() && connection->getRemoteAddress() == "1.1.20"_pa);
+
+    // T_Data_Connected is delivered once and acknowledged every time
+    KnxTelegram data = transportTelegram("1.1.20"_pa, KNX_COMM_NDP, 0);
+    data.setCommand(KNX_COMMAND_MASK_VERSION_READ);
+    data.setPayloadLength(2);
+    tpuart.injectTelegram(&data);
+    tpuart.injectTelegram(&data, 20000);
+    CHECK(run(&knx, 100000, KNX_TELEGRAM) == 1);
+    CHECK(connection->getDuplicateCount() == 1);
+    CHECK(tpuart.getSentFrameCount() == 2);
+    for (int i = 0; i < tpuart.getSentFrameCount(); i++) {
+        KnxTelegramView ack(tpuart.getSentFrame(i)->data);
+        CHECK(ack.getCommunicationType() == KNX_COMM_NCD && ack.getControlData() == KNX_CONTROLDATA_POS_CONFIRM);
+        CHECK(ack.getSequenceNumber() == 0 && ack.getTargetIndividualAddress() == "1.1.20"_pa);
+    }
+
+    // Out of sequence: T_NAK
+    data.setSequenceNumber(5);
+    tpuart.injectTelegram(&data);
+    CHECK(run(&knx, 50000, KNX_TELEGRAM) == 0);
+    CHECK(lastSentFrame(&tpuart).getControlData() == KNX_CONTROLDATA_NEG_CONFIRM);
+    CHECK(lastSentFrame(&tpuart).getSequenceNumber() == 5);
+    CHECK(connection->getReceiveSequence() == 1);
+
+    // The answer gets our sequence number and is repeated until its T_ACK
+    CHECK(knx.individualAnswerMaskVersion(1, 1, 20));
+    run(&knx, 100000);
+    int sent = tpuart.getSentFrameCount();
+    CHECK(lastSentFrame(&tpuart).getCommunicationType() == KNX_COMM_NDP);
+    CHECK(lastSentFrame(&tpuart).getSequenceNumber() == 0);
+    CHECK(!knx.sendConnected(&data));
+    run(&knx, TPUART_TRANSPORT_ACK_TIMEOUT_MS * 1000UL);
+    CHECK(tpuart.getSentFrameCount() == sent + 1);
+    CHECK(connection->getRepetitionCount() == 1);
+    CHECK(lastSentFrame(&tpuart).getSequenceNumber() == 0);
+
+    control = transportTelegram("1.1.20"_pa, KNX_COMM_NCD, 0);
+    control.setControlData(KNX_CONTROLDATA_POS_CONFIRM);
+    tpuart.injectTelegram(&control);
+    CHECK(run(&knx, 50000, KNX_TELEGRAM) == 0);
+    CHECK(connection->getState() == KNX_TRANSPORT_OPEN_IDLE);
+    CHECK(connection->getSendSequence() == 1);
+
+    // Silence ends the connection with T_Disconnect
+    run(&knx, TPUART_TRANSPORT_CONNECTION_TIMEOUT_MS * 1000UL);
+    CHECK(!connection->isOpen());
+    CHECK(lastSentFrame(&tpuart).getCommunicationType() == KNX_COMM_UCD);
+    CHECK(lastSentFrame(&tpuart).getControlData() == KNX_CONTROLDATA_DISCONNECT);
+
+    // As client: another device trying to connect is turned down
+    knx.connect("1.1.30"_pa);
+    run(&knx, 50000);
+    CHECK(lastSentFrame(&tpuart).getControlData() == KNX_CONTROLDATA_CONNECT);
+    CHECK(lastSentFrame(&tpuart).getTargetIndividualAddress() == "1.1.30"_pa);
+    control = transportTelegram("1.1.20"_pa, KNX_COMM_UCD, 0);
+    control.setControlData(KNX_CONTROLDATA_CONNECT);
+    tpuart.injectTelegram(&control);
+    run(&knx, 50000);
+    CHECK(lastSentFrame(&tpuart).getControlData() == KNX_CONTROLDATA_DISCONNECT);
+    CHECK(lastSentFrame(&tpuart).getTargetIndividualAddress() == "1.1.20"_pa);
+    CHECK(connection->getRemoteAddress() == "1.1.30"_pa);
+}
+
+static void testThroughput() {
+    KnxTpUartEmulator tpuart;
+    KnxTpUart knx(&tpuart, "1.1.10"_pa);
+    knx.setTxCallback(txCallback, 0);
+    knx.setTxBudget(KNX_PRIORITY_NORMAL, 100);
+    knx.setBusLoadLimit(100);
+    resetCounters();
+
+    // Keep the queue filled for 10 s
+    unsigned long end = micros() + 10000000UL;
+    while (micros() < end) {
+        while (knx.getTxQueueCount() < TPUART_TX_QUEUE_SIZE) {
+            knx.groupWrite2ByteFloat("1/2/3"_ga, 20.0);
+        }
+        knx.serialEvent();
+        knx.loop();
+        hostAdvanceMicros(LOOP_US);
+    }
+
+    CHECK(failedCount == 0);
+    printf("throughput: %d telegrams/s, bus load %lu%%\n",
+        confirmCount / 10, tpuart.getBusBusyMicros() / 100000UL);
+}
+
+int main() {
+    testGroupWrite();
+    testReceive();
+    testGroupHandlers();
+    testGroupObjects();
+    testTelegramPool();
+    testExtendedFrames();
+    testNotAcknowledged();
+    testRetry();
+    testErrors();
+    testResync();
+    testMonitor();
+    testStartupBurst();
+    testBusLoadEstimate();
+    testCoalescing();
+    testPrepared();
+    testSendFilter();
+    testRxRing();
+    testTransportConnection();
+    testThroughput();
+
+    if (failures > 0) {
+        printf("EmulatorTest: %d failures\n", failures);
+        return 1;
+    }
+    printf("EmulatorTest: ok\n");
+    return 0;
+}
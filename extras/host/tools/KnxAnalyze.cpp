@@ -0,0 +1,341 @@
+/*
+ * Offline analysis of a bus capture (see KnxCapture.h): statistics per
+ * group address in one pass, sharded across cores.
+ *
+ *   KnxAnalyze [-j threads] [-t ga:dpt ...] [-a] capture
+ *
+ *   -j  number of threads, default: all cores
+ *   -t  decode the values of a group address with a DPT main number, e.g.
+ *       -t 1/2/3:5. Without, the DPT is guessed from the payload length:
+ *       1 bit: 1, 1 byte: 5, 2 byte: 9, 4 byte: 14
+ *   -a  list all source devices, not only the top 3
+ *
+ * Per group address: telegrams, rate, share of the bus time taken by the
+ * telegrams to it, repetitions, min/max/last value and the sending devices.
+ * Extended frames longer than a record are counted as truncated, not analyzed.
+ */
+#include <thread>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <algorithm>
+#include <unistd.h>
+
+#include "KnxCapture.h"
+
+// Bus time of a frame in bit times, as in KnxTpUartEmulator
+#define BUS_CHAR_BITS 13
+#define BUS_OVERHEAD_BITS (50 + 15 + 11)    // idle before, gap and acknowledge after
+
+#define GROUP_ADDRESS_COUNT 65536
+
+struct GroupStats {
+    uint64_t count;
+    uint64_t repeated;
+    uint64_t busBits;
+    uint64_t values;
+    double min;
+    double max;
+    double last;
+};
+
+struct ShardResult {
+    std::vector<GroupStats> groups;
+    std::unordered_map<uint32_t, uint64_t> sources;    // group address << 16 | source
+    uint64_t telegrams;
+    uint64_t checksumErrors;
+    uint64_t truncated;
+    uint64_t otherEvents;
+    uint64_t busBits;
+};
+
+static byte dpts[GROUP_ADDRESS_COUNT];     // 0 = guess from the payload length
+
+/*
+ * Checksum test of a batch of records: the XOR over all bytes of a valid
+ * telegram, checksum included, is 0xFF. The inner loop runs over all 24
+ * data bytes of a record, those past the frame length masked by a compare,
+ * so the compiler vectorizes it at -O2 (check with -fopt-info-vec). Position
+ * and length are signed bytes, SSE2 compares only those in one instruction.
+ */
+#define CHECKSUM_BATCH 256
+
+static void verifyChecksums(const KnxCaptureRecord* records, int count, byte* valid) {
+    for (int i = 0; i < count; i++) {
+        const KnxCaptureRecord& record = records[i];
+        int8_t length = record.length < sizeof(record.data) ? record.length : sizeof(record.data);
+
+        byte x = 0;
+        for (int8_t j = 0; j < (int8_t) sizeof(record.data); j++) {
+            x ^= record.data[j] & (byte) -(j < length);
+        }
+        valid[i] = x == 0xFF;
+    }
+}
+
+/*
+ * Value of a group telegram as number, false if the DPT is not numeric
+ * or does not match the payload
+ */
+static bool decodeValue(KnxTelegramView& view, int dpt, double* value) {
+    int length = view.getPayloadLength();
+    if (dpt == 0) {
+        switch (length) {
+            case 2: dpt = 1; break;
+            case 3: dpt = 5; break;
+            case 4: dpt = 9; break;
+            case 6: dpt = 14; break;
+            default: return false;
+        }
+    }
+
+    switch (dpt) {
+        case 1: *value = view.getValue<Dpt<1> >(); return length == Dpt<1>::PAYLOAD_LENGTH;
+        case 5: *value = view.getValue<Dpt<5> >(); return length == Dpt<5>::PAYLOAD_LENGTH;
+        case 6: *value = view.getValue<Dpt<6> >(); return length == Dpt<6>::PAYLOAD_LENGTH;
+        case 7: *value = view.getValue<Dpt<7> >(); return length == Dpt<7>::PAYLOAD_LENGTH;
+        case 8: *value = view.getValue<Dpt<8> >(); return length == Dpt<8>::PAYLOAD_LENGTH;
+        case 9: *value = view.getValue<Dpt<9> >(); return length == Dpt<9>::PAYLOAD_LENGTH;
+        case 12: *value = view.getValue<Dpt<12> >(); return length == Dpt<12>::PAYLOAD_LENGTH;
+        case 13: *value = view.getValue<Dpt<13> >(); return length == Dpt<13>::PAYLOAD_LENGTH;
+        case 14: *value = view.getValue<Dpt<14> >(); return length == Dpt<14>::PAYLOAD_LENGTH;
+        default: return false;
+    }
+}
+
+static void analyzeShard(KnxCaptureReader* reader, uint32_t first, uint32_t end, ShardResult* result) {
+    result->groups.assign(GROUP_ADDRESS_COUNT, GroupStats());
+    result->telegrams = 0;
+    result->checksumErrors = 0;
+    result->truncated = 0;
+    result->otherEvents = 0;
+    result->busBits = 0;
+
+    byte valid[CHECKSUM_BATCH];
+    for (uint32_t batch = first; batch < end; batch += CHECKSUM_BATCH) {
+        int count = end - batch < CHECKSUM_BATCH ? end - batch : CHECKSUM_BATCH;
+        verifyChecksums(reader->getRecord(batch), count, valid);
+
+        for (int i = 0; i < count; i++) {
+            if (reader->getRecord(batch + i)->event == KNX_TELEGRAM_ERROR) {
+                // Rejected by the receive path already
+                result->checksumErrors++;
+                continue;
+            }
+            if (reader->getRecord(batch + i)->flags & KNX_CAPTURE_TRUNCATED) {
+                // Extended frame, checked by the receive path but not stored in full
+                result->truncated++;
+                continue;
+            }
+            if (!reader->isTelegram(batch + i)) {
+                result->otherEvents++;
+                continue;
+            }
+            if (!valid[i]) {
+                result->checksumErrors++;
+                continue;
+            }
+
+            KnxTelegramView view = reader->getTelegram(batch + i);
+            uint64_t bits = view.getTotalLength() * BUS_CHAR_BITS + BUS_OVERHEAD_BITS;
+            result->telegrams++;
+            result->busBits += bits;
+            if (!view.isTargetGroup()) {
+                continue;
+            }
+
+            uint16_t groupAddress = view.getTargetGroupAddress().getValue();
+            GroupStats& stats = result->groups[groupAddress];
+            stats.count++;
+            stats.busBits += bits;
+            if (view.isRepeated()) {
+                stats.repeated++;
+            }
+            result->sources[(uint32_t) groupAddress << 16 | view.getSourceAddress().getValue()]++;
+
+            KnxCommandType command = view.getCommand();
+            double value;
+            if ((command == KNX_COMMAND_WRITE || command == KNX_COMMAND_ANSWER)
+                    && decodeValue(view, dpts[groupAddress], &value)) {
+                if (stats.values == 0 || value < stats.min) {
+                    stats.min = value;
+                }
+                if (stats.values == 0 || value > stats.max) {
+                    stats.max = value;
+                }
+                stats.last = value;
+                stats.values++;
+            }
+        }
+    }
+}
+
+/*
+ * Adds a shard to the total, shards are merged in capture order
+ */
+static void merge(ShardResult* total, const ShardResult& shard) {
+    for (int i = 0; i < GROUP_ADDRESS_COUNT; i++) {
+        const GroupStats& from = shard.groups[i];
+        GroupStats& to = total->groups[i];
+        if (from.count == 0) {
+            continue;
+        }
+        to.count += from.count;
+        to.repeated += from.repeated;
+        to.busBits += from.busBits;
+        if (from.values > 0) {
+            if (to.values == 0 || from.min < to.min) {
+                to.min = from.min;
+            }
+            if (to.values == 0 || from.max > to.max) {
+                to.max = from.max;
+            }
+            to.last = from.last;
+            to.values += from.values;
+        }
+    }
+    for (std::unordered_map<uint32_t, uint64_t>::const_iterator it = shard.sources.begin(); it != shard.sources.end(); ++it) {
+        total->sources[it->first] += it->second;
+    }
+    total->telegrams += shard.telegrams;
+    total->checksumErrors += shard.checksumErrors;
+    total->truncated += shard.truncated;
+    total->otherEvents += shard.otherEvents;
+    total->busBits += shard.busBits;
+}
+
+static String formatGroupAddress(uint16_t value) {
+    return String(value >> 11) + "/" + String((value >> 8) & B111) + "/" + String(value & 0xFF);
+}
+
+static String formatIndividualAddress(uint16_t value) {
+    return String(value >> 12) + "." + String((value >> 8) & B1111) + "." + String(value & 0xFF);
+}
+
+static bool parseDpt(const char* arg) {
+    const char* colon = strchr(arg, ':');
+    if (colon == 0) {
+        return false;
+    }
+    std::string address(arg, colon - arg);
+    dpts[KnxGroupAddress(address.c_str()).getValue()] = atoi(colon + 1);
+    return true;
+}
+
+static int usage() {
+    fprintf(stderr, "usage: KnxAnalyze [-j threads] [-t ga:dpt ...] [-a] capture\n");
+    return 2;
+}
+
+int main(int argc, char** argv) {
+    int threads = std::thread::hardware_concurrency();
+    bool allSources = false;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "j:t:a")) != -1) {
+        switch (opt) {
+            case 'j':
+                threads = atoi(optarg);
+                break;
+            case 't':
+                if (!parseDpt(optarg)) {
+                    return usage();
+                }
+                break;
+            case 'a':
+                allSources = true;
+                break;
+            default:
+                return usage();
+        }
+    }
+    if (optind != argc - 1) {
+        return usage();
+    }
+    if (threads < 1) {
+        threads = 1;
+    }
+
+    KnxCaptureReader reader;
+    if (!reader.open(argv[optind])) {
+        fprintf(stderr, "cannot read capture %s\n", argv[optind]);
+        return 1;
+    }
+    uint32_t recordCount = reader.getRecordCount();
+    if (recordCount == 0) {
+        printf("empty capture\n");
+        return 0;
+    }
+
+    // Contiguous shards of whole checksum batches
+    uint32_t batches = (recordCount + CHECKSUM_BATCH - 1) / CHECKSUM_BATCH;
+    if ((uint32_t) threads > batches) {
+        threads = batches;
+    }
+    std::vector<ShardResult> shards(threads);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++) {
+        uint32_t first = (uint64_t) batches * t / threads * CHECKSUM_BATCH;
+        uint32_t end = (uint64_t) batches * (t + 1) / threads * CHECKSUM_BATCH;
+        if (end > recordCount) {
+            end = recordCount;
+        }
+        workers.push_back(std::thread(analyzeShard, &reader, first, end, &shards[t]));
+    }
+
+    ShardResult total;
+    total.groups.assign(GROUP_ADDRESS_COUNT, GroupStats());
+    total.telegrams = 0;
+    total.checksumErrors = 0;
+    total.truncated = 0;
+    total.otherEvents = 0;
+    total.busBits = 0;
+    for (int t = 0; t < threads; t++) {
+        workers[t].join();
+        merge(&total, shards[t]);
+        shards[t] = ShardResult();
+    }
+
+    // Sources per group address, most frequent first
+    std::map<uint16_t, std::vector<std::pair<uint64_t, uint16_t> > > sources;
+    for (std::unordered_map<uint32_t, uint64_t>::iterator it = total.sources.begin(); it != total.sources.end(); ++it) {
+        sources[it->first >> 16].push_back(std::make_pair(it->second, (uint16_t) it->first));
+    }
+
+    double seconds = (reader.getRecord(recordCount - 1)->time - reader.getRecord(0)->time) / 1e6;
+    double busSeconds = total.busBits / 9600.0;
+    printf("%u records, %.0f s, %llu telegrams, %llu checksum errors, %llu truncated, %llu other events, bus load %.1f%%\n",
+        recordCount, seconds, (unsigned long long) total.telegrams, (unsigned long long) total.checksumErrors,
+        (unsigned long long) total.truncated, (unsigned long long) total.otherEvents,
+        seconds > 0 ? 100.0 * busSeconds / seconds : 0.0);
+    printf("%-10s %10s %9s %7s %7s %12s %12s %12s  %s\n",
+        "group", "telegrams", "per min", "load%", "repeat%", "min", "max", "last", "sources");
+
+    for (int i = 0; i < GROUP_ADDRESS_COUNT; i++) {
+        const GroupStats& stats = total.groups[i];
+        if (stats.count == 0) {
+            continue;
+        }
+
+        printf("%-10s %10llu %9.2f %7.2f %7.2f", formatGroupAddress(i).c_str(), (unsigned long long) stats.count,
+            seconds > 0 ? stats.count * 60.0 / seconds : 0.0,
+            100.0 * stats.busBits / total.busBits, 100.0 * stats.repeated / stats.count);
+        if (stats.values > 0) {
+            printf(" %12g %12g %12g ", stats.min, stats.max, stats.last);
+        } else {
+            printf(" %12s %12s %12s ", "-", "-", "-");
+        }
+
+        std::vector<std::pair<uint64_t, uint16_t> >& list = sources[i];
+        std::sort(list.rbegin(), list.rend());
+        size_t shown = allSources ? list.size() : std::min(list.size(), (size_t) 3);
+        for (size_t s = 0; s < shown; s++) {
+            printf(" %s:%llu", formatIndividualAddress(list[s].second).c_str(), (unsigned long long) list[s].first);
+        }
+        if (shown < list.size()) {
+            printf(" +%u", (unsigned int) (list.size() - shown));
+        }
+        printf("\n");
+    }
+    return 0;
+}